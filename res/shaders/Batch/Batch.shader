@@ -0,0 +1,133 @@
+#shader vertex
+#version 330 core
+
+//  One source for the batch rendering tests; a variant only has what its keywords ask for (Shader::GetVariant()):
+//      VERTEX_COLOR    a color per vertex, in place of u_Color
+//      TEXTURED        texture coordinates per vertex, sampling u_Texture
+//      MAX_TEXTURES=N  with TEXTURED: a tex index per vertex, sampling u_Textures[N]
+//      TEXTURE_ARRAY   with TEXTURED: a layer per vertex, sampling the sampler2DArray u_Textures
+//      INSTANCED       with TEXTURED: a transform, a color and a uv rect per instance (divisor 1), from location 4
+//      TINT            with TEXTURED: the texture is multiplied by the color, instead of shown as it is
+//      MODEL_MATRIX    the vertices are moved by u_Model; without it they're already in world space
+//  The camera is the frame's (FrameUniforms), so a draw sets at most u_Model.
+//  The per-vertex attributes take consecutive locations in this order, skipping the ones a variant doesn't have,
+//  the same way VertexArray numbers the elements of a layout. The per-instance ones start at a fixed location,
+//  passed to VertexArray::AddBuffer(), so they don't move with the per-vertex ones.
+
+#if defined(MAX_TEXTURES) && defined(TEXTURE_ARRAY)
+#error MAX_TEXTURES and TEXTURE_ARRAY both pick the sampler
+#endif
+#if (defined(MAX_TEXTURES) || defined(TEXTURE_ARRAY) || defined(INSTANCED) || defined(TINT)) && !defined(TEXTURED)
+#error MAX_TEXTURES, TEXTURE_ARRAY, INSTANCED and TINT need TEXTURED
+#endif
+#if defined(INSTANCED) && (defined(VERTEX_COLOR) || defined(MAX_TEXTURES) || defined(TEXTURE_ARRAY))
+#error INSTANCED takes its color and texture from the instance
+#endif
+
+layout(location=0) in vec4 a_Position;
+
+#ifdef VERTEX_COLOR
+layout(location=1) in vec4 a_Color;
+out vec4 v_Color;
+#define LOCATION_TEXCOORD 2
+#define LOCATION_TEXINDEX 3
+#else
+#define LOCATION_TEXCOORD 1
+#define LOCATION_TEXINDEX 2
+#endif
+
+#ifdef TEXTURED
+layout(location=LOCATION_TEXCOORD) in vec2 a_TexCoord;
+out vec2 v_TexCoord;
+#endif
+
+#if defined(MAX_TEXTURES) || defined(TEXTURE_ARRAY)
+//  The index of a sampler of u_Textures, or the layer of the texture array.
+layout(location=LOCATION_TEXINDEX) in float a_TexIndex;
+out float v_TexIndex;
+#endif
+
+#ifdef INSTANCED
+//  A mat4 takes 4 locations.
+layout(location=4) in mat4 a_Transform;
+layout(location=8) in vec4 a_Color;
+//  The part of the texture the instance shows: xy is the corner, zw the size.
+layout(location=9) in vec4 a_UVRect;
+out vec4 v_Color;
+#endif
+
+#include "../include/Frame.glsl"
+
+#ifdef MODEL_MATRIX
+uniform mat4 u_Model;
+#define TRANSFORM(position) (u_ViewProjection * u_Model * (position))
+#else
+#define TRANSFORM(position) (u_ViewProjection * (position))
+#endif
+
+void main()
+{
+#if defined(VERTEX_COLOR) || defined(INSTANCED)
+    v_Color = a_Color;
+#endif
+#if defined(MAX_TEXTURES) || defined(TEXTURE_ARRAY)
+    v_TexIndex = a_TexIndex;
+#endif
+
+#ifdef INSTANCED
+    v_TexCoord = a_UVRect.xy + a_TexCoord * a_UVRect.zw;
+    gl_Position = TRANSFORM(a_Transform * a_Position);
+#else
+#ifdef TEXTURED
+    v_TexCoord = a_TexCoord;
+#endif
+    gl_Position = TRANSFORM(a_Position);
+#endif
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location=0) out vec4 o_Color;
+
+#if defined(VERTEX_COLOR) || defined(INSTANCED)
+in vec4 v_Color;
+#define COLOR v_Color
+#else
+uniform vec4 u_Color;
+#define COLOR u_Color
+#endif
+
+#ifdef TEXTURED
+in vec2 v_TexCoord;
+#endif
+
+#if defined(MAX_TEXTURES)
+in float v_TexIndex;
+//  Sized by the variant, e.g. to GL_MAX_TEXTURE_IMAGE_UNITS (Shader::GetMaxTextureUnits()).
+uniform sampler2D u_Textures[MAX_TEXTURES];
+#elif defined(TEXTURE_ARRAY)
+in float v_TexIndex;
+//  The layer is just the third coordinate, so it doesn't have to be the same across a draw call.
+uniform sampler2DArray u_Textures;
+#elif defined(TEXTURED)
+uniform sampler2D u_Texture;
+#endif
+
+void main()
+{
+#if defined(MAX_TEXTURES)
+    o_Color = texture(u_Textures[int(v_TexIndex)], v_TexCoord);
+#elif defined(TEXTURE_ARRAY)
+    o_Color = texture(u_Textures, vec3(v_TexCoord, v_TexIndex));
+#elif defined(TEXTURED)
+    o_Color = texture(u_Texture, v_TexCoord);
+#else
+    o_Color = COLOR;
+#endif
+
+#ifdef TINT
+    o_Color *= COLOR;
+#endif
+};
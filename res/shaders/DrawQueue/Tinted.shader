@@ -0,0 +1,32 @@
+#shader vertex
+#version 330 core
+
+layout(location=0) in vec4 position;
+layout(location=1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+    gl_Position = u_MVP * position;
+    v_TexCoord = texCoord;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location=0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+    //  Tinted by the texture coordinates, so it's easy to tell apart from the Basic shader on screen.
+    vec4 texColor = texture(u_Texture, v_TexCoord);
+    color = texColor * vec4(v_TexCoord, 1.0, 1.0);
+};
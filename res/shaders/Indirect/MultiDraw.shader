@@ -0,0 +1,46 @@
+#shader vertex
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location=0) in vec4 position;
+layout(location=1) in vec2 texCoord;
+
+//  One per draw of the glMultiDrawElementsIndirect call; must match IndirectDrawData on the C++ side.
+struct DrawData
+{
+    mat4 MVP;
+    int TexIndex;
+};
+
+layout(std430, binding=0) readonly buffer DrawDataBuffer
+{
+    DrawData u_Draws[];
+};
+
+out vec2 v_TexCoord;
+flat out int v_TexIndex;
+
+void main()
+{
+    //  gl_DrawIDARB is which draw of the multi-draw this vertex belongs to, starting from 0.
+    DrawData draw = u_Draws[gl_DrawIDARB];
+    gl_Position = draw.MVP * position;
+    v_TexCoord = texCoord;
+    v_TexIndex = draw.TexIndex;
+};
+
+
+#shader fragment
+#version 430 core
+
+layout(location=0) out vec4 color;
+
+in vec2 v_TexCoord;
+flat in int v_TexIndex;
+
+uniform sampler2D u_Textures[4];
+
+void main()
+{
+    color = texture(u_Textures[v_TexIndex], v_TexCoord);
+};
@@ -0,0 +1,32 @@
+#shader vertex
+#version 330 core
+
+layout(location=0) in vec4 position;
+layout(location=1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+//  Set for every draw, since without gl_DrawID there's no way to look them up.
+uniform mat4 u_MVP;
+
+void main()
+{
+    gl_Position = u_MVP * position;
+    v_TexCoord = texCoord;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location=0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform int u_TexIndex;
+uniform sampler2D u_Textures[4];
+
+void main()
+{
+    color = texture(u_Textures[u_TexIndex], v_TexCoord);
+};
@@ -0,0 +1,46 @@
+#shader vertex
+#version 330 core
+
+layout(location=0) in vec4 a_Position;
+layout(location=1) in vec4 a_Color;
+layout(location=2) in vec2 a_TexCoord;
+layout(location=3) in float a_TexIndex;
+
+//  The vertices are already in world space, so the frame's camera is all there is to it.
+#include "../include/Frame.glsl"
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+out float v_TexIndex;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_TexIndex = a_TexIndex;
+
+    gl_Position = u_ViewProjection * a_Position;
+};
+
+
+#shader fragment
+#version 330 core
+
+layout(location=0) out vec4 o_Color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+in float v_TexIndex;
+
+//  Renderer2D defines MAX_TEXTURES as the slots it uses: at most MaxTextureSlots, and no more than the GPU's units.
+//  Slot 0 is the white texture.
+#ifndef MAX_TEXTURES
+#error Quad.shader is compiled with MAX_TEXTURES=N
+#endif
+uniform sampler2D u_Textures[MAX_TEXTURES];
+
+void main()
+{
+    int index = int(v_TexIndex);
+    o_Color = texture(u_Textures[index], v_TexCoord) * v_Color;
+};
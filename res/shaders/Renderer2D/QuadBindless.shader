@@ -0,0 +1,46 @@
+#shader vertex
+#version 430 core
+
+layout(location=0) in vec4 a_Position;
+layout(location=1) in vec4 a_Color;
+layout(location=2) in vec2 a_TexCoord;
+layout(location=3) in float a_TexIndex;
+
+//  The vertices are already in world space, so the frame's camera is all there is to it.
+#include "../include/Frame.glsl"
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out int v_TexIndex;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_TexIndex = int(a_TexIndex);
+
+    gl_Position = u_ViewProjection * a_Position;
+};
+
+
+#shader fragment
+#version 430 core
+#extension GL_ARB_bindless_texture : require
+
+layout(location=0) out vec4 o_Color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+//  Flat, so the handle is the same across each quad's triangles.
+flat in int v_TexIndex;
+
+//  The handles of this batch's textures, uploaded by Renderer2D before each draw. Index 0 is the white texture.
+layout(std430, binding=0) readonly buffer TextureHandles
+{
+    sampler2D u_Handles[];
+};
+
+void main()
+{
+    o_Color = texture(u_Handles[v_TexIndex], v_TexCoord) * v_Color;
+};
@@ -0,0 +1,11 @@
+//  The per frame uniforms, bound to FrameUniforms::Binding by Shader; has to match FrameUniforms::Data.
+layout(std140) uniform Frame
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    mat4 u_ViewProjection;
+    //  Seconds since the app started.
+    float u_Time;
+    //  In pixels.
+    vec2 u_Viewport;
+};
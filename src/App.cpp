@@ -26,6 +26,8 @@
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <cstring>
+#include <chrono>
 
 #include "Renderer.h"
 #include "VertexBuffer.h"
@@ -34,6 +36,21 @@
 #include "VertexBufferLayout.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "QuadIndexBuffer.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "JobSystem.h"
+#include "TextureStreamer.h"
+#include "BindlessTextures.h"
+#include "AssetManager.h"
+#include "AssetPack.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderCompiler.h"
+#include "ShaderPreprocessor.h"
+#include "FrameUniforms.h"
+#include "Instrumentor.h"
+#include "Benchmark.h"
+#include "TextureCooker.h"
 #include "glm/glm.hpp"
 //#include "glm/gtx/io.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -45,19 +62,110 @@
 #include "tests/TestBatchRenderingColors.h"
 #include "tests/TestBatchRenderingTextures.h"
 #include "tests/TestBatchRenderingDynamicGeometry.h"
+#include "tests/TestRenderer2D.h"
+#include "tests/TestDrawQueue.h"
+#include "tests/TestMultiDrawIndirect.h"
+#include "tests/TestInstancedSprites.h"
+#include "tests/TestParallelSprites.h"
+#include "tests/TestTextureAtlas.h"
+#include "tests/TestTextureArray.h"
+#include "tests/TestTextureCompression.h"
 
 
-int main(void)
+/**
+*   Function to create Tests
+*
+*   //  The function is templated.
+*   The same list is used by the menu and by the benchmark.
+*/
+static void RegisterTests(test::TestMenu& menu)
+{
+	menu.RegisterTest<test::TestClearColor>("Clear Color");
+	menu.RegisterTest<test::BasicRendererTest>("Basic Renderer");
+	menu.RegisterTest<test::TestTexture2D>("Texture 2D");
+	menu.RegisterTest<test::TestBatchRendering>("Batch Rendering");
+	menu.RegisterTest<test::TestBatchRenderingColors>("Batch Rendering - Color");
+	menu.RegisterTest<test::TestBatchRenderingTextures>("Batch Rendering - Textures");
+	menu.RegisterTest<test::TestBatchRenderingDynamicGeometry>("Batch Rendering - Dynamic Geometry");
+	menu.RegisterTest<test::TestRenderer2D>("Renderer2D");
+	menu.RegisterTest<test::TestDrawQueue>("Draw Queue");
+	menu.RegisterTest<test::TestMultiDrawIndirect>("Multi-Draw Indirect");
+	menu.RegisterTest<test::TestInstancedSprites>("Instanced Sprites");
+	menu.RegisterTest<test::TestParallelSprites>("Parallel Sprites");
+	menu.RegisterTest<test::TestTextureAtlas>("Texture Atlas");
+	menu.RegisterTest<test::TestTextureArray>("Texture Array");
+	menu.RegisterTest<test::TestTextureCompression>("Texture Compression");
+}
+
+
+int main(int argc, char** argv)
 {
+	//  --cook turns images into mipmapped, block compressed .ktx files and exits; it needs no window or context.
+	TextureCooker::Options cookOptions;
+	std::vector<std::string> cookInputs;
+	if (TextureCooker::ParseArgs(argc, argv, cookOptions, cookInputs))
+		return TextureCooker::Run(cookOptions, cookInputs) == 0 ? 0 : 1;
+
+	//  --pack builds one memory mapped pack out of res/ and exits; --use-pack file loads the assets from it instead.
+	AssetPack::Options packOptions;
+	if (AssetPack::ParseArgs(argc, argv, packOptions))
+		return AssetPack::Build(packOptions) ? 0 : 1;
+
+	//  --bench runs every test without the UI and writes the timings to a file; see Benchmark.
+	Benchmark::Options benchOptions;
+	bool bench = Benchmark::ParseArgs(argc, argv, benchOptions);
+
+	//  --no-error asks for a context that doesn't check for errors at all (KHR_no_error).
+	bool noErrorContext = false;
+	//  --no-shader-cache compiles every shader, e.g. to compare cold and warm starts.
+	bool shaderCache = true;
+	std::string packPath;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--no-error") == 0)
+			noErrorContext = true;
+		else if (std::strcmp(argv[i], "--no-shader-cache") == 0)
+			shaderCache = false;
+		else if (std::strcmp(argv[i], "--use-pack") == 0 && i + 1 < argc)
+			packPath = argv[++i];
+	}
+
 	/**
 	*   From the GLFW library
 	*/
 	GLFWwindow* window;
 
+	/**
+	*   Headless: GLFW's null platform needs no display, and OSMesa renders on the CPU, so the benchmark also runs
+	*   on machines with no GPU. GLEW has to be built for OSMesa (GLEW_OSMESA) then, since the usual build looks
+	*   the functions up through WGL/GLX and finds none on an OSMesa context; so it's only compiled in with that.
+	*/
+	bool headless = bench && benchOptions.Headless;
+#ifdef GLEW_OSMESA
+	if (headless)
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+	if (headless)
+	{
+		std::cout << "--headless needs GLEW built with GLEW_OSMESA, and this build's GLEW isn't.\n";
+		return -1;
+	}
+#endif
+
 	/* Initialize the library */
 	if (!glfwInit())
 		return -1;
 
+	if (bench)
+	{
+		//  Nothing is shown while benchmarking.
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLEW_OSMESA
+		if (headless)
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+	}
+
 	/**
 	*   @Exp
 	*   By specifying these pieces of code, these are done:
@@ -65,8 +173,9 @@ int main(void)
 	*   Also Core OPENGL Profile is being used.
 	*   This profile requires that a VertexArrayObject be made explicitely.
 	*/
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	//  4.6 is asked for first, for multi-draw indirect and gl_DrawID; below it's retried with 3.3.
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
 	/**
 	*   The COMPAT profile is the one specified above by the major and minor versions, 3.3
 	*   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
@@ -74,9 +183,27 @@ int main(void)
 	*/
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+	/**
+	*   A debug context is what makes the driver report errors through the debug callback; it can't also be a
+	*   no-error context. Release builds don't check for errors, so they don't need a debug context.
+	*/
+	if (noErrorContext)
+		glfwWindowHint(GLFW_CONTEXT_NO_ERROR, GLFW_TRUE);
+#ifndef NDEBUG
+	else
+		glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
 	/* Create a windowed mode window and its OpenGL context */
 	window = glfwCreateWindow(960, 540, "Yo! World!", NULL, NULL);
 	if (!window)
+	{
+		//  Drivers that don't have 4.6 (macOS stops at 4.1) fail to create the window, so fall back to 3.3.
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		window = glfwCreateWindow(960, 540, "Yo! World!", NULL, NULL);
+	}
+	if (!window)
 	{
 		glfwTerminate();
 		return -1;
@@ -86,20 +213,106 @@ int main(void)
 	glfwMakeContextCurrent(window);
 
 	/* Syncing Frame Rate */
-	glfwSwapInterval(1);
+	//  Not when benchmarking: waiting for the monitor would hide how long the frames really take.
+	glfwSwapInterval(bench ? 0 : 1);
 
 	//  Initialize GLEW; now one can use the GL Functions.
 	//  All the functions are function pointers.
-	if (glewInit() != GLEW_OK)
-		std::cout << "Error!\n";
+	//  Without the functions every GL call would go through a null pointer, so there's no going on.
+	GLenum glewError = glewInit();
+	if (glewError != GLEW_OK)
+	{
+		std::cout << "Could not initialize GLEW: " << glewGetErrorString(glewError) << "\n";
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return -1;
+	}
 
 	//  Print out version.
 	std::cout << glGetString(GL_VERSION) << "\n";
 
+	//  Errors come through the debug callback where there is one, instead of glGetError around every call.
+	if (noErrorContext)
+		GLDebug::SetMode(GLDebug::Mode::Off);
+	else
+		GLDebug::SetMode(GLDebug::Mode::Callback);
+
 	{
+		//  The state cache for this window's context; every wrapper binds through it.
+		GLStateCache stateCache;
+		GLStateCache::MakeCurrent(&stateCache);
+
 		//  glEnable(GL_BLEND) can be declared with glBelndFunc9) in any order.
-		GLCall(glEnable(GL_BLEND));
-		GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+		stateCache.SetBlend(true);
+		stateCache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		//  The camera, time and viewport every batch shader reads, uploaded once a frame instead of per draw.
+		std::unique_ptr<FrameUniforms> frameUniforms = std::make_unique<FrameUniforms>();
+		FrameUniforms::MakeCurrent(frameUniforms.get());
+
+		//  Tests load their textures and shaders through this, so opening one again doesn't load them again.
+		AssetManager assets;
+		AssetManager::MakeCurrent(&assets);
+
+		//  Before anything is loaded, so every asset the pack has comes from it.
+		std::unique_ptr<AssetPack> pack;
+		if (!packPath.empty())
+		{
+			pack = std::make_unique<AssetPack>(packPath);
+			if (pack->IsOpen())
+				AssetPack::MakeCurrent(pack.get());
+			else
+				std::cout << "Couldn't open the asset pack " << packPath << ", loading from the files\n";
+		}
+
+		//  Shaders linked on an earlier run are loaded from their program binaries.
+		std::unique_ptr<ProgramBinaryCache> programCache;
+		if (shaderCache && ProgramBinaryCache::IsSupported())
+		{
+			programCache = std::make_unique<ProgramBinaryCache>();
+			ProgramBinaryCache::MakeCurrent(programCache.get());
+		}
+
+		if (bench)
+		{
+			test::Test* unused = nullptr;
+			test::TestMenu benchMenu(unused);
+			RegisterTests(benchMenu);
+
+			bool written = Benchmark::Run(window, benchMenu, benchOptions);
+
+			//  Everything is deleted here, while there still is a context.
+			assets.ClearCache();
+			AssetManager::MakeCurrent(nullptr);
+			QuadIndexBuffer::Shutdown();
+			FrameUniforms::MakeCurrent(nullptr);
+			frameUniforms.reset();
+			GLStateCache::MakeCurrent(nullptr);
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return written ? 0 : 1;
+		}
+
+		//  Times the GPU work of each test; its results show up a few frames late.
+		GpuProfiler gpuProfiler;
+		GpuProfiler::MakeCurrent(&gpuProfiler);
+		test::Test* profiledTest = nullptr;
+
+		//  Made here so the render thread is thread 0 of the job system.
+		JobSystem& jobSystem = JobSystem::Get();
+
+		//  Textures made with TextureLoad::Async are decoded on the job system and uploaded through it.
+		std::unique_ptr<TextureStreamer> textureStreamer;
+		if (TextureStreamer::IsSupported())
+			textureStreamer = std::make_unique<TextureStreamer>();
+		TextureStreamer::MakeCurrent(textureStreamer.get());
+		bool streamTextures = textureStreamer != nullptr;
+
+		//  Shaders made with ShaderLoad::Async compile in the driver while the frames go on. Not for the benchmark,
+		//  which would time the fallback program.
+		std::unique_ptr<ShaderCompiler> shaderCompiler = std::make_unique<ShaderCompiler>();
+		ShaderCompiler::MakeCurrent(shaderCompiler.get());
+		bool compileAsync = true;
 
 
 		Renderer renderer;
@@ -127,65 +340,214 @@ int main(void)
 		//  The below is because we want the display to start with the menu first.
 		currentTest = testMenu;
 
-		/**
-		*   Function to create Tests
-		*
-		*   //  The function is templated.
-		*/
-		testMenu->RegisterTest<test::TestClearColor>("Clear Color");
-		testMenu->RegisterTest<test::BasicRendererTest>("Basic Renderer");
-		testMenu->RegisterTest<test::TestTexture2D>("Texture 2D");
-		testMenu->RegisterTest<test::TestBatchRendering>("Batch Rendering");
-		testMenu->RegisterTest<test::TestBatchRenderingColors>("Batch Rendering - Color");
-		testMenu->RegisterTest<test::TestBatchRenderingTextures>("Batch Rendering - Textures");
-		testMenu->RegisterTest<test::TestBatchRenderingDynamicGeometry>("Batch Rendering - Dynamic Geometry");
+		RegisterTests(*testMenu);
 
 
 		//test::TestClearColor test;
 
 		/* Loop until the user closes the window */
+		//  How long the CPU spent on each frame, not counting the wait for vsync in glfwSwapBuffers.
+		double cpuFrameTime = 0.0;
+#ifndef NDEBUG
+		//  Only debug builds check for errors, so only they can switch how.
+		int errorMode = (int)GLDebug::GetMode();
+#endif
+
+		//  Frames left to record in the CPU trace; 0 when no trace is being recorded.
+		int traceFramesLeft = 0;
+		double lastFrameTime = glfwGetTime();
+
 		while (!glfwWindowShouldClose(window))
 		{
+			PROFILE_SCOPE("Frame");
+			auto frameStart = std::chrono::high_resolution_clock::now();
+			double now = glfwGetTime();
+			float deltaTime = (float)(now - lastFrameTime);
+			lastFrameTime = now;
+			gpuProfiler.BeginFrame();
+			jobSystem.UpdateUtilization();
+			if (textureStreamer)
+				textureStreamer->Update();
+			shaderCompiler->Update();
+			int framebufferWidth, framebufferHeight;
+			glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+			frameUniforms->BeginFrame((float)now, glm::vec2((float)framebufferWidth, (float)framebufferHeight));
+
 			/* Render here */
 
 			GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
 			renderer.Clear();
 
-			// Start the Dear ImGui frame
-			ImGui_ImplOpenGL3_NewFrame();
-			ImGui_ImplGlfw_NewFrame();
-			ImGui::NewFrame();
-
 			if (currentTest)
 			{
-				currentTest->OnUpdate(0.0f);
-				currentTest->OnRender();
-				ImGui::Begin("Test");
-				//  If this back button is called, t
-				if (currentTest != testMenu && ImGui::Button("<-"))
 				{
-					delete currentTest;
-					currentTest = testMenu;
+					PROFILE_SCOPE("OnUpdate");
+					currentTest->OnUpdate(deltaTime);
+				}
+				//  Numbers from one test mean nothing for the next one.
+				if (currentTest != profiledTest)
+				{
+					gpuProfiler.Reset();
+					profiledTest = currentTest;
+				}
+				{
+					PROFILE_SCOPE("OnRender");
+					GPU_PROFILE_SCOPE("Test::OnRender");
+					currentTest->OnRender();
+				}
+			}
+
+			//  Every ImGui window of the frame is built in here.
+			{
+				PROFILE_SCOPE("ImGui Build");
+				// Start the Dear ImGui frame
+				ImGui_ImplOpenGL3_NewFrame();
+				ImGui_ImplGlfw_NewFrame();
+				ImGui::NewFrame();
+
+				if (currentTest)
+				{
+					ImGui::Begin("Test");
+					//  If this back button is called, t
+					if (currentTest != testMenu && ImGui::Button("<-"))
+					{
+						delete currentTest;
+						currentTest = testMenu;
+					}
+					currentTest->OnImGuiRender();
+
+					const GLStateCache::Stats& stateStats = stateCache.GetStats();
+					ImGui::Text("GL state changes: %llu issued, %llu skipped", stateStats.Issued, stateStats.Skipped);
+					const FrameUniforms::Stats& frameStats = frameUniforms->GetStats();
+					ImGui::Text("Frame uniforms: %llu uploads, %llu camera updates skipped", frameStats.Uploads, frameStats.Skipped);
+					//  Renderer2D picks the bindless texture path whenever it's supported.
+					if (BindlessTextures::IsSupported())
+						ImGui::Text("Textures: bindless, %u resident", BindlessTextures::GetResidentCount());
+					else
+						ImGui::Text("Textures: slots (no ARB_bindless_texture)");
+					if (programCache)
+						programCache->OnImGuiRender();
+					else
+						ImGui::Text("Shaders: always compiled (no program binary cache)");
+
+					ImGui::Text("CPU frame: %.3f ms", cpuFrameTime);
+#ifndef NDEBUG
+					//  Switching lets the cost of each kind of error checking be compared in the same run.
+					ImGui::Text("GL errors:"); ImGui::SameLine();
+					ImGui::RadioButton("glGetError", &errorMode, (int)GLDebug::Mode::GetError); ImGui::SameLine();
+					ImGui::RadioButton("Callback", &errorMode, (int)GLDebug::Mode::Callback); ImGui::SameLine();
+					ImGui::RadioButton("Off", &errorMode, (int)GLDebug::Mode::Off);
+					if (errorMode != (int)GLDebug::GetMode())
+						errorMode = (int)GLDebug::SetMode((GLDebug::Mode)errorMode);
+#else
+					ImGui::Text("GL errors: not checked (release build)");
+#endif
+
+					if (ImGui::CollapsingHeader("GPU Profiler"))
+						gpuProfiler.OnImGuiRender();
+					if (ImGui::CollapsingHeader("Job System"))
+						jobSystem.OnImGuiRender();
+					if (ImGui::CollapsingHeader("Assets"))
+					{
+						assets.OnImGuiRender();
+						if (AssetPack::Get())
+							AssetPack::Get()->OnImGuiRender();
+						else
+							ImGui::Text("No asset pack; loading from the files (--use-pack)");
+					}
+					if (ImGui::CollapsingHeader("Shader Compilation"))
+					{
+						//  Off, every shader compiles before its test's constructor returns, to compare how long opening takes.
+						if (ImGui::Checkbox("Compile shaders asynchronously", &compileAsync))
+							ShaderCompiler::MakeCurrent(compileAsync ? shaderCompiler.get() : nullptr);
+						shaderCompiler->OnImGuiRender();
+						const ShaderPreprocessor::Stats& preprocessor = ShaderPreprocessor::GetStats();
+						ImGui::Text("Preprocessed %u shaders in %.2f ms (%u files read, %u from cache)", preprocessor.Shaders, preprocessor.Time, preprocessor.FilesRead, preprocessor.CacheHits);
+					}
+					if (textureStreamer && ImGui::CollapsingHeader("Texture Streaming"))
+					{
+						//  Turning it off makes tests load their textures synchronously again, to compare their time to first frame.
+						if (ImGui::Checkbox("Stream textures", &streamTextures))
+							TextureStreamer::MakeCurrent(streamTextures ? textureStreamer.get() : nullptr);
+						textureStreamer->OnImGuiRender();
+					}
+
+#if PROFILING
+					if (traceFramesLeft > 0)
+						ImGui::Text("Recording CPU trace... %d frames left", traceFramesLeft);
+					else if (ImGui::Button("Record CPU trace (120 frames)"))
+					{
+						Instrumentor::Get().BeginSession();
+						traceFramesLeft = 120;
+					}
+#endif
+					ImGui::End();
 				}
-				currentTest->OnImGuiRender();
-				ImGui::End();
 			}
 
 
+			//  Counts only what the test did this frame.
+			stateCache.ResetStats();
+
 			// Rendering
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			{
+				PROFILE_SCOPE("ImGui::Render");
+				ImGui::Render();
+			}
+			{
+				PROFILE_SCOPE("ImGui Render");
+				GPU_PROFILE_SCOPE("ImGui");
+				ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			}
+			//  ImGui binds its own program, buffers and textures without going through the cache.
+			stateCache.Invalidate();
+
+			gpuProfiler.EndFrame();
+
+			auto frameEnd = std::chrono::high_resolution_clock::now();
+			cpuFrameTime = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+
 			/* Swap front and back buffers */
-			GLCall(glfwSwapBuffers(window));
+			{
+				PROFILE_SCOPE("Swap");
+				GLCall(glfwSwapBuffers(window));
+			}
 
 			/* Poll for and process events */
-			GLCall(glfwPollEvents());
+			{
+				PROFILE_SCOPE("Poll");
+				GLCall(glfwPollEvents());
+			}
+
+			//  Open cpu_trace.json in chrome://tracing or ui.perfetto.dev.
+			if (traceFramesLeft > 0 && --traceFramesLeft == 0)
+				Instrumentor::Get().EndSession("cpu_trace.json");
 		}
 
 		delete currentTest;
 		if (currentTest != testMenu)
 			delete testMenu;
 
+		if (programCache)
+		{
+			const ProgramBinaryCache::Stats& shaderStats = programCache->GetStats();
+			std::cout << "Shaders: " << shaderStats.Hits << " from binaries in " << shaderStats.WarmTime << " ms, "
+				<< shaderStats.Misses << " compiled in " << shaderStats.ColdTime << " ms\n";
+		}
+
+		//  Shared GL resources have to go before the context does.
+		QuadIndexBuffer::Shutdown();
+		//  Before the streamer, since cached textures may still be waiting on it.
+		assets.ClearCache();
+		AssetManager::MakeCurrent(nullptr);
+		ShaderCompiler::MakeCurrent(nullptr);
+		shaderCompiler.reset();
+		TextureStreamer::MakeCurrent(nullptr);
+		textureStreamer.reset();
+		FrameUniforms::MakeCurrent(nullptr);
+		frameUniforms.reset();
+		GLStateCache::MakeCurrent(nullptr);
+
 		//  Imgui Cleanup
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
@@ -0,0 +1,251 @@
+#include "AssetManager.h"
+
+#include "Renderer.h"
+#include "Instrumentor.h"
+
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+
+static thread_local AssetManager* s_Current = nullptr;
+
+static size_t TextureSize(const void* asset)
+{
+    return ((const Texture*)asset)->GetSize();
+}
+
+static size_t ShaderSize(const void* asset)
+{
+    //  What the driver keeps of a linked program is close to its binary; drivers without binaries count as nothing.
+    const Shader* shader = (const Shader*)asset;
+    //  It keeps its variants for as long as it lives.
+    size_t size = 0;
+    for (const auto& variant : shader->GetVariants())
+        size += ShaderSize(variant.second.get());
+
+    int length = 0;
+    //  Asking a program that is still linking would wait for it.
+    if (!shader->IsReady())
+        return size;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+    {
+        GLCall(glGetProgramiv(shader->GetRendererID(), GL_PROGRAM_BINARY_LENGTH, &length));
+    }
+    return size + (size_t)std::max(length, 0);
+}
+
+
+AssetManager::AssetManager(size_t cacheBudget)
+    : m_CachedBytes(0), m_CacheBudget(cacheBudget)
+{
+}
+
+AssetManager::~AssetManager()
+{
+    //  Handles still out there would point at deleted assets.
+    for (const auto& entry : m_Entries)
+        ASSERT(entry.second.Cached);
+}
+
+AssetManager& AssetManager::Get()
+{
+    ASSERT(s_Current);
+    return *s_Current;
+}
+
+void AssetManager::MakeCurrent(AssetManager* manager)
+{
+    s_Current = manager;
+}
+
+std::string AssetManager::CanonicalPath(const std::string& path)
+{
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+#ifdef _WIN32
+    //  The file system doesn't care about case there, so neither may the keys.
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+#endif
+
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (begin <= normalized.size())
+    {
+        size_t end = normalized.find('/', begin);
+        if (end == std::string::npos)
+            end = normalized.size();
+
+        std::string part = normalized.substr(begin, end - begin);
+        if (part == "..")
+        {
+            if (!parts.empty() && parts.back() != "..")
+                parts.pop_back();
+            else
+                parts.push_back(part);
+        }
+        else if (!part.empty() && part != ".")
+            parts.push_back(part);
+
+        begin = end + 1;
+    }
+
+    std::string result = !normalized.empty() && normalized[0] == '/' ? "/" : "";
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        if (i > 0)
+            result += '/';
+        result += parts[i];
+    }
+    return result;
+}
+
+std::shared_ptr<Texture> AssetManager::GetTexture(const std::string& path, TextureLoad load)
+{
+    std::string key = std::string(load == TextureLoad::Async ? "texture:async:" : "texture:sync:") + CanonicalPath(path);
+    if (std::shared_ptr<Texture> texture = Find<Texture>(key))
+        return texture;
+
+    PROFILE_SCOPE("AssetManager Load Texture");
+    return Add(key, std::make_unique<Texture>(path, load), &TextureSize);
+}
+
+std::shared_ptr<Shader> AssetManager::GetShader(const std::string& path, ShaderLoad load)
+{
+    //  Both ways end in the same program, so they share one entry.
+    std::string key = "shader:" + CanonicalPath(path);
+    if (std::shared_ptr<Shader> shader = Find<Shader>(key))
+    {
+        if (load == ShaderLoad::Sync)
+            shader->Finish();
+        return shader;
+    }
+
+    PROFILE_SCOPE("AssetManager Load Shader");
+    return Add(key, std::make_unique<Shader>(path, load), &ShaderSize);
+}
+
+std::shared_ptr<Shader> AssetManager::GetShaderVariant(const std::string& path, const std::vector<std::string>& keywords, ShaderLoad load)
+{
+    std::vector<std::string> sorted = keywords;
+    std::string variantKey = Shader::MakeVariantKey(sorted);
+    if (sorted.empty())
+        return GetShader(path, load);
+
+    std::string key = "shader:" + CanonicalPath(path) + "|" + variantKey;
+    if (std::shared_ptr<Shader> shader = Find<Shader>(key))
+    {
+        if (load == ShaderLoad::Sync)
+            shader->Finish();
+        return shader;
+    }
+
+    PROFILE_SCOPE("AssetManager Load Shader");
+    return Add(key, std::make_unique<Shader>(path, load, sorted), &ShaderSize);
+}
+
+template<typename T>
+std::shared_ptr<T> AssetManager::Find(const std::string& key)
+{
+    auto it = m_Entries.find(key);
+    if (it == m_Entries.end())
+    {
+        m_Stats.Misses++;
+        return nullptr;
+    }
+
+    Entry& entry = it->second;
+    if (!entry.Cached)
+    {
+        m_Stats.LiveHits++;
+        return std::static_pointer_cast<T>(entry.Handle.lock());
+    }
+
+    m_Stats.CacheHits++;
+    m_LRU.erase(entry.LRUPosition);
+    m_CachedBytes -= entry.Bytes;
+    entry.Cached = false;
+    return Share<T>(key, entry);
+}
+
+template<typename T>
+std::shared_ptr<T> AssetManager::Add(const std::string& key, std::unique_ptr<T> asset, size_t (*sizeOf)(const void*))
+{
+    Entry& entry = m_Entries[key];
+    entry.Asset = std::shared_ptr<T>(std::move(asset));
+    entry.SizeOf = sizeOf;
+    entry.Bytes = 0;
+    entry.Cached = false;
+    return Share<T>(key, entry);
+}
+
+template<typename T>
+std::shared_ptr<T> AssetManager::Share(const std::string& key, Entry& entry)
+{
+    //  The handle's "deleter" hands the asset back to the manager instead of deleting it.
+    std::shared_ptr<T> handle((T*)entry.Asset.get(), [this, key](T*) { OnReleased(key); });
+    entry.Handle = handle;
+    return handle;
+}
+
+void AssetManager::OnReleased(const std::string& key)
+{
+    auto it = m_Entries.find(key);
+    ASSERT(it != m_Entries.end());
+    Entry& entry = it->second;
+
+    entry.Bytes = entry.SizeOf(entry.Asset.get());
+    entry.Cached = true;
+    m_LRU.push_front(key);
+    entry.LRUPosition = m_LRU.begin();
+    m_CachedBytes += entry.Bytes;
+
+    Evict(m_CacheBudget);
+}
+
+void AssetManager::Evict(size_t budget)
+{
+    while (m_CachedBytes > budget && !m_LRU.empty())
+    {
+        auto it = m_Entries.find(m_LRU.back());
+        m_CachedBytes -= it->second.Bytes;
+        m_LRU.pop_back();
+        m_Entries.erase(it);
+        m_Stats.Evictions++;
+    }
+}
+
+void AssetManager::SetCacheBudget(size_t bytes)
+{
+    m_CacheBudget = bytes;
+    Evict(m_CacheBudget);
+}
+
+void AssetManager::ClearCache()
+{
+    //  Assets that take no bytes would survive Evict(0).
+    while (!m_LRU.empty())
+    {
+        auto it = m_Entries.find(m_LRU.back());
+        m_CachedBytes -= it->second.Bytes;
+        m_LRU.pop_back();
+        m_Entries.erase(it);
+        m_Stats.Evictions++;
+    }
+    //  So the shaders loaded next read their files (and includes) again.
+    ShaderPreprocessor::ClearCache();
+}
+
+void AssetManager::OnImGuiRender()
+{
+    ImGui::Text("Assets: %u (%u cached, %.1f MB)", GetAssetCount(), GetCachedCount(), m_CachedBytes / (1024.0 * 1024.0));
+    ImGui::Text("Hits: %u in use, %u cached; misses: %u; evictions: %u", m_Stats.LiveHits, m_Stats.CacheHits, m_Stats.Misses, m_Stats.Evictions);
+
+    int budget = (int)(m_CacheBudget / (1024 * 1024));
+    if (ImGui::SliderInt("Cache budget (MB)", &budget, 0, 1024))
+        SetCacheBudget((size_t)budget * 1024 * 1024);
+    if (ImGui::Button("Clear cache"))
+        ClearCache();
+}
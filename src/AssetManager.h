@@ -0,0 +1,100 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+#include "Shader.h"
+
+/**
+*	Loads each texture and shader once and hands out shared handles to it.
+*
+*	Assets are keyed by their canonical path (so "res/a/../b.png" and "res\\b.png" are the same file) and their load
+*	options. Asking for one that is already in use returns the same object. When the last handle to an asset is
+*	released it isn't deleted right away: it goes into an LRU cache, and is only deleted once the cached assets take
+*	up more than the byte budget, least recently released first. So closing a test and opening it again, or opening
+*	another test with the same images, costs a lookup instead of decoding and compiling everything again.
+*
+*	A shared Shader keeps its uniforms between users, so whoever uses one sets the uniforms it relies on.
+*	Only the render thread may use the manager, and it must outlive every handle it gave out.
+*/
+class AssetManager
+{
+public:
+	struct Stats
+	{
+		//	Asked for an asset that was in use, one that was in the cache, and one that had to be loaded.
+		unsigned int LiveHits = 0;
+		unsigned int CacheHits = 0;
+		unsigned int Misses = 0;
+		unsigned int Evictions = 0;
+	};
+
+	explicit AssetManager(size_t cacheBudget = 256 * 1024 * 1024);
+	~AssetManager();
+
+	AssetManager(const AssetManager&) = delete;
+	AssetManager& operator=(const AssetManager&) = delete;
+
+	//	The manager of this thread's context; one must have been made current.
+	static AssetManager& Get();
+	static void MakeCurrent(AssetManager* manager);
+
+	std::shared_ptr<Texture> GetTexture(const std::string& path, TextureLoad load = TextureLoad::Sync);
+	//	Asking Sync for a shader that is still compiling Async waits for it.
+	std::shared_ptr<Shader> GetShader(const std::string& path, ShaderLoad load = ShaderLoad::Sync);
+	//	The variant of the shader with `keywords` (see Shader::GetVariant()), without compiling the shader without them.
+	//	Each variant is an asset of its own, cached like any other.
+	std::shared_ptr<Shader> GetShaderVariant(const std::string& path, const std::vector<std::string>& keywords, ShaderLoad load = ShaderLoad::Sync);
+
+	//	Evicts cached assets straight away if they no longer fit.
+	void SetCacheBudget(size_t bytes);
+	inline size_t GetCacheBudget() const { return m_CacheBudget; }
+	//	Deletes every cached asset; assets in use aren't affected.
+	void ClearCache();
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline size_t GetCachedBytes() const { return m_CachedBytes; }
+	inline unsigned int GetCachedCount() const { return (unsigned int)m_LRU.size(); }
+	inline unsigned int GetAssetCount() const { return (unsigned int)m_Entries.size(); }
+	void OnImGuiRender();
+
+	//	Makes a path comparable: forward slashes, no "." or "dir/.." parts, no doubled separators.
+	static std::string CanonicalPath(const std::string& path);
+
+private:
+	struct Entry
+	{
+		//	The only owning pointer; the handles given out don't own the asset, they tell the manager when they're gone.
+		std::shared_ptr<void> Asset;
+		std::weak_ptr<void> Handle;
+		//	How much memory the asset takes, worked out when it's released since e.g. a streamed texture grows.
+		size_t (*SizeOf)(const void* asset);
+		size_t Bytes;
+		//	Where it is in m_LRU while it's cached (not in use).
+		bool Cached;
+		std::list<std::string>::iterator LRUPosition;
+	};
+
+	template<typename T>
+	std::shared_ptr<T> Find(const std::string& key);
+	template<typename T>
+	std::shared_ptr<T> Add(const std::string& key, std::unique_ptr<T> asset, size_t (*sizeOf)(const void*));
+	template<typename T>
+	std::shared_ptr<T> Share(const std::string& key, Entry& entry);
+
+	void OnReleased(const std::string& key);
+	void Evict(size_t budget);
+
+private:
+	std::unordered_map<std::string, Entry> m_Entries;
+	//	The keys of the cached assets, the most recently released at the front.
+	std::list<std::string> m_LRU;
+	size_t m_CachedBytes;
+	size_t m_CacheBudget;
+
+	Stats m_Stats;
+};
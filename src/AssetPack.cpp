@@ -0,0 +1,486 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "JobSystem.h"
+#include "Lz4.h"
+#include "Instrumentor.h"
+#include "imgui/imgui.h"
+
+
+static thread_local AssetPack* s_Current = nullptr;
+
+static const char PackMagic[4] = { 'G', 'L', 'P', 'K' };
+
+static bool IsImage(const std::string& path)
+{
+    std::string extension = path.substr(std::min(path.size(), path.find_last_of('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+}
+
+//  Every file under `directory`, recursively.
+static void ListFiles(const std::string& directory, std::vector<std::string>& files)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA found;
+    HANDLE search = FindFirstFileA((directory + "/*").c_str(), &found);
+    if (search == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        std::string name = found.cFileName;
+        if (name == "." || name == "..")
+            continue;
+        if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            ListFiles(directory + "/" + name, files);
+        else
+            files.push_back(directory + "/" + name);
+    } while (FindNextFileA(search, &found));
+    FindClose(search);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return;
+    while (dirent* found = readdir(dir))
+    {
+        std::string name = found->d_name;
+        if (name == "." || name == "..")
+            continue;
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+            continue;
+        if (S_ISDIR(info.st_mode))
+            ListFiles(path, files);
+        else if (S_ISREG(info.st_mode))
+            files.push_back(path);
+    }
+    closedir(dir);
+#endif
+}
+
+static bool ReadFile(const std::string& path, std::vector<unsigned char>& contents)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    contents.resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read((char*)contents.data(), contents.size());
+    return (bool)file;
+}
+
+/**
+*   Cuts `data` into blocks and compresses them all on the JobSystem. Returns false, leaving `stored` alone,
+*   if that doesn't save at least an eighth, since every load of the entry then pays for decompressing it.
+*/
+static bool CompressBlocks(const std::vector<unsigned char>& data, std::vector<unsigned char>& stored)
+{
+    const size_t blockCount = (data.size() + AssetPack::BlockSize - 1) / AssetPack::BlockSize;
+    std::vector<std::vector<unsigned char>> blocks(blockCount);
+    JobSystem::Get().ParallelFor((unsigned int)blockCount, 1, [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; i++)
+        {
+            size_t offset = (size_t)i * AssetPack::BlockSize;
+            blocks[i] = Lz4::Compress(data.data() + offset, std::min((size_t)AssetPack::BlockSize, data.size() - offset));
+        }
+    });
+
+    size_t size = blockCount * sizeof(uint32_t);
+    for (const std::vector<unsigned char>& block : blocks)
+        size += block.size();
+    if (size > data.size() - data.size() / 8)
+        return false;
+
+    stored.clear();
+    stored.reserve(size);
+    for (const std::vector<unsigned char>& block : blocks)
+    {
+        uint32_t blockSize = (uint32_t)block.size();
+        stored.insert(stored.end(), (const unsigned char*)&blockSize, (const unsigned char*)&blockSize + sizeof(blockSize));
+    }
+    for (const std::vector<unsigned char>& block : blocks)
+        stored.insert(stored.end(), block.begin(), block.end());
+    return true;
+}
+
+static size_t AlignUp(size_t value)
+{
+    return (value + AssetPack::Alignment - 1) / AssetPack::Alignment * AssetPack::Alignment;
+}
+
+bool AssetPack::ParseArgs(int argc, char** argv, Options& options)
+{
+    //  The texture options are the cooker's; it has nothing to cook here.
+    std::vector<std::string> unused;
+    TextureCooker::ParseArgs(argc, argv, options.Texture, unused);
+
+    bool pack = false;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--pack") == 0)
+            pack = true;
+        else if (std::strcmp(argv[i], "--lz4") == 0)
+            options.Compress = true;
+        else if (std::strcmp(argv[i], "--pack-root") == 0 && hasValue)
+            options.Root = argv[++i];
+        else if (std::strcmp(argv[i], "--pack-out") == 0 && hasValue)
+            options.OutputPath = argv[++i];
+    }
+    return pack;
+}
+
+bool AssetPack::Build(const Options& options)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<std::string> files;
+    ListFiles(NormalizePath(options.Root), files);
+    //  So the same directory always makes the same pack.
+    std::sort(files.begin(), files.end());
+    if (files.empty())
+    {
+        std::cout << "Nothing to pack in " << options.Root << '\n';
+        return false;
+    }
+
+    std::ofstream out(options.OutputPath, std::ios::binary);
+    if (!out)
+    {
+        std::cout << "Couldn't write " << options.OutputPath << '\n';
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.Magic, PackMagic, sizeof(PackMagic));
+    header.Version = Version;
+    header.EntryCount = (uint32_t)files.size();
+    header.NamesSize = 0;
+
+    std::vector<Entry> entries(files.size());
+    std::string names;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        std::memset(&entries[i], 0, sizeof(Entry));
+        entries[i].NameOffset = (uint32_t)names.size();
+        entries[i].NameLength = (uint32_t)files[i].size();
+        names += files[i];
+    }
+    header.NamesSize = (uint32_t)names.size();
+
+    //  The data starts after the table and the names; they're written last, once every entry knows where it is.
+    size_t offset = AlignUp(sizeof(Header) + entries.size() * sizeof(Entry) + names.size());
+    size_t totalSize = 0;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        Entry& entry = entries[i];
+        std::vector<unsigned char> data;
+
+        if (IsImage(files[i]))
+        {
+            CookedTexture texture;
+            if (!TextureCooker::CookFile(files[i], options.Texture, texture))
+            {
+                std::cout << "Couldn't decode " << files[i] << ", skipping it\n";
+                continue;
+            }
+            entry.Type = EntryType::Texture;
+            entry.Format = (uint32_t)texture.Format;
+            entry.Width = texture.Width;
+            entry.Height = texture.Height;
+            entry.LevelCount = (uint32_t)texture.Levels.size();
+            data.reserve(texture.GetSize());
+            for (const std::vector<unsigned char>& level : texture.Levels)
+                data.insert(data.end(), level.begin(), level.end());
+        }
+        else if (!ReadFile(files[i], data))
+        {
+            std::cout << "Couldn't read " << files[i] << ", skipping it\n";
+            continue;
+        }
+        else
+            entry.Type = EntryType::File;
+
+        std::vector<unsigned char> compressed;
+        bool isCompressed = options.Compress && !data.empty() && CompressBlocks(data, compressed);
+        const std::vector<unsigned char>& stored = isCompressed ? compressed : data;
+
+        entry.Offset = offset;
+        entry.Size = data.size();
+        entry.StoredSize = stored.size();
+        entry.BlockSize = isCompressed ? BlockSize : 0;
+
+        out.seekp((std::streamoff)offset);
+        out.write((const char*)stored.data(), stored.size());
+        offset = AlignUp(offset + stored.size());
+        totalSize += data.size();
+
+        std::cout << "Packed " << files[i] << ": " << data.size() / 1024 << " KB"
+            << (isCompressed ? ", LZ4 to " + std::to_string(stored.size() / 1024) + " KB" : "") << '\n';
+    }
+
+    //  Entries that were skipped have no data; they're left out of the table.
+    std::vector<Entry> written;
+    std::string writtenNames;
+    for (const Entry& entry : entries)
+    {
+        if (entry.Offset == 0)
+            continue;
+        Entry copy = entry;
+        copy.NameOffset = (uint32_t)writtenNames.size();
+        writtenNames += names.substr(entry.NameOffset, entry.NameLength);
+        written.push_back(copy);
+    }
+    header.EntryCount = (uint32_t)written.size();
+    header.NamesSize = (uint32_t)writtenNames.size();
+
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)written.data(), written.size() * sizeof(Entry));
+    out.write(writtenNames.data(), writtenNames.size());
+    //  Makes the file as long as its last entry's padding, so every entry is inside it.
+    out.seekp((std::streamoff)offset - 1);
+    out.put(0);
+
+    std::cout << "Wrote " << options.OutputPath << ": " << written.size() << " entries, " << totalSize / 1024 << " KB of assets in "
+        << offset / 1024 << " KB\n";
+    return (bool)out;
+}
+
+AssetPack::AssetPack(const std::string& path)
+    : m_Path(path), m_Data(nullptr), m_Size(0), m_File(nullptr), m_Mapping(nullptr)
+{
+    PROFILE_FUNCTION();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+    m_File = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        Unmap();
+        return;
+    }
+    m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_Mapping)
+        m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+    m_Size = (size_t)size.QuadPart;
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return;
+
+    struct stat info;
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping != MAP_FAILED)
+        {
+            m_Data = (const unsigned char*)mapping;
+            m_Size = (size_t)info.st_size;
+        }
+    }
+    //  The mapping keeps the file open by itself.
+    close(file);
+#endif
+
+    if (m_Data && !Validate())
+    {
+        std::cout << path << " isn't a valid asset pack\n";
+        Unmap();
+    }
+}
+
+AssetPack::~AssetPack()
+{
+    if (s_Current == this)
+        s_Current = nullptr;
+    Unmap();
+}
+
+AssetPack* AssetPack::Get()
+{
+    return s_Current;
+}
+
+void AssetPack::MakeCurrent(AssetPack* pack)
+{
+    s_Current = pack;
+}
+
+void AssetPack::Unmap()
+{
+#ifdef _WIN32
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+    if (m_File)
+        CloseHandle(m_File);
+#else
+    if (m_Data)
+        munmap((void*)m_Data, m_Size);
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+    m_File = nullptr;
+    m_Mapping = nullptr;
+    m_Entries.clear();
+}
+
+bool AssetPack::Validate()
+{
+    if (m_Size < sizeof(Header))
+        return false;
+    const Header* header = (const Header*)m_Data;
+    if (std::memcmp(header->Magic, PackMagic, sizeof(PackMagic)) != 0 || header->Version != Version)
+        return false;
+
+    const size_t namesOffset = sizeof(Header) + (size_t)header->EntryCount * sizeof(Entry);
+    if (namesOffset + header->NamesSize > m_Size)
+        return false;
+
+    const Entry* entries = (const Entry*)(m_Data + sizeof(Header));
+    const char* names = (const char*)(m_Data + namesOffset);
+    for (uint32_t i = 0; i < header->EntryCount; i++)
+    {
+        const Entry& entry = entries[i];
+        if ((uint64_t)entry.NameOffset + entry.NameLength > header->NamesSize || entry.Offset > m_Size || entry.StoredSize > m_Size - entry.Offset)
+            return false;
+        m_Entries[std::string(names + entry.NameOffset, entry.NameLength)] = &entry;
+    }
+    return true;
+}
+
+std::string AssetPack::NormalizePath(const std::string& path)
+{
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+    return normalized;
+}
+
+const AssetPack::Entry* AssetPack::Find(const std::string& path) const
+{
+    auto it = m_Entries.find(NormalizePath(path));
+    return it != m_Entries.end() ? it->second : nullptr;
+}
+
+bool AssetPack::Load(const std::string& path, Data& data)
+{
+    PROFILE_FUNCTION();
+
+    const Entry* entry = Find(path);
+    if (!entry)
+        return false;
+
+    m_Stats.Loads++;
+    if (entry->BlockSize == 0)
+    {
+        data.Storage.clear();
+        data.Bytes = m_Data + entry->Offset;
+        data.Size = (size_t)entry->Size;
+        m_Stats.BytesMapped += data.Size;
+        return true;
+    }
+
+    if (!Decompress(*entry, data))
+    {
+        std::cout << "The pack's " << path << " is corrupt\n";
+        return false;
+    }
+    m_Stats.BytesDecompressed += data.Size;
+    return true;
+}
+
+bool AssetPack::Decompress(const Entry& entry, Data& data) const
+{
+    const size_t blockCount = (size_t)((entry.Size + entry.BlockSize - 1) / entry.BlockSize);
+    const uint32_t* blockSizes = (const uint32_t*)(m_Data + entry.Offset);
+    if (blockCount * sizeof(uint32_t) > entry.StoredSize)
+        return false;
+
+    //  Where each block starts, so they can all be decompressed at once.
+    std::vector<size_t> offsets(blockCount);
+    size_t offset = blockCount * sizeof(uint32_t);
+    for (size_t i = 0; i < blockCount; i++)
+    {
+        offsets[i] = offset;
+        offset += blockSizes[i];
+    }
+    if (offset > entry.StoredSize)
+        return false;
+
+    data.Storage.resize((size_t)entry.Size);
+    std::atomic<bool> valid(true);
+    const unsigned char* stored = m_Data + entry.Offset;
+    JobSystem::Get().ParallelFor((unsigned int)blockCount, 1, [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; i++)
+        {
+            size_t start = (size_t)i * entry.BlockSize;
+            size_t size = std::min((size_t)entry.BlockSize, data.Storage.size() - start);
+            if (!Lz4::Decompress(stored + offsets[i], blockSizes[i], data.Storage.data() + start, size))
+                valid.store(false, std::memory_order_relaxed);
+        }
+    });
+
+    data.Bytes = data.Storage.data();
+    data.Size = data.Storage.size();
+    return valid.load();
+}
+
+bool AssetPack::LoadTexture(const std::string& path, CookedTextureView& texture, Data& data)
+{
+    const Entry* entry = Find(path);
+    if (!entry || entry->Type != EntryType::Texture || !Load(path, data))
+        return false;
+
+    texture.Format = (TextureFormat)entry->Format;
+    texture.Width = entry->Width;
+    texture.Height = entry->Height;
+    texture.Levels.clear();
+
+    size_t offset = 0;
+    for (uint32_t level = 0; level < entry->LevelCount; level++)
+    {
+        int width = std::max(1, texture.Width >> level), height = std::max(1, texture.Height >> level);
+        size_t size = TextureCooker::GetLevelSize(texture.Format, width, height);
+        if (offset + size > data.Size)
+            return false;
+        texture.Levels.push_back(data.Bytes + offset);
+        offset += size;
+    }
+    return !texture.Levels.empty();
+}
+
+void AssetPack::OnImGuiRender() const
+{
+    ImGui::Text("Asset pack %s: %u entries, %.1f MB mapped", m_Path.c_str(), (unsigned int)m_Entries.size(), m_Size / (1024.0 * 1024.0));
+    ImGui::Text("Loads: %u, %.2f MB straight from the mapping, %.2f MB decompressed", m_Stats.Loads,
+        m_Stats.BytesMapped / (1024.0 * 1024.0), m_Stats.BytesDecompressed / (1024.0 * 1024.0));
+}
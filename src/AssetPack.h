@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureCooker.h"
+
+/**
+*	One file holding every shader and texture of res/, memory mapped, so loading an asset is a lookup in its table
+*	of contents instead of opening a file and reading (and for images, decoding) it.
+*
+*	The pack is built offline (App --pack) from a directory:
+*		-	images are cooked with the TextureCooker, so their levels can go to glCompressedTexImage2D as they are,
+*		-	every other file (e.g. the .shader files) is stored as it is.
+*	With --lz4, an entry is cut into blocks of BlockSize and each block compressed with Lz4, as long as that makes the
+*	entry noticeably smaller; the blocks are decompressed in parallel on the JobSystem when it's loaded.
+*
+*	Entries are found by the path they had when the pack was built (e.g. "res/shaders/Renderer2D/Quad.shader"), so
+*	while a pack is current (MakeCurrent()), Shader and Texture look their path up in it first and only go to the
+*	file system for what it doesn't have; none of the code loading assets has to change.
+*	Stored entries are never copied: Load() hands out pointers into the mapping, and a texture's levels are uploaded
+*	straight from it.
+*
+*	The layout: a Header, the table of Entries, the names, then the data of each entry aligned to Alignment.
+*/
+class AssetPack
+{
+public:
+	static const uint32_t Version = 1;
+	static const uint32_t Alignment = 64;
+	static const uint32_t BlockSize = 256 * 1024;
+
+	enum class EntryType : uint32_t
+	{
+		File = 0,
+		//	The levels of a cooked texture, one after the other.
+		Texture = 1
+	};
+
+	struct Header
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t NamesSize;
+	};
+
+	struct Entry
+	{
+		uint32_t NameOffset, NameLength;
+		EntryType Type;
+		//	A TextureFormat, for textures.
+		uint32_t Format;
+		uint64_t Offset;
+		//	The bytes in the pack, and the bytes once decompressed; the same if it isn't compressed.
+		uint64_t StoredSize, Size;
+		//	0 if the entry isn't compressed. Otherwise the data starts with the compressed size of every block as a uint32.
+		uint32_t BlockSize;
+		int32_t Width, Height;
+		uint32_t LevelCount;
+	};
+
+	//	What an entry holds: in the mapping if it's stored as it is, in Storage if it had to be decompressed.
+	struct Data
+	{
+		const unsigned char* Bytes = nullptr;
+		size_t Size = 0;
+		std::vector<unsigned char> Storage;
+
+		Data() = default;
+		Data(Data&&) = default;
+		Data& operator=(Data&&) = default;
+		//	Bytes may point into Storage, so a copy would point into the original.
+		Data(const Data&) = delete;
+		Data& operator=(const Data&) = delete;
+	};
+
+	struct Options
+	{
+		std::string Root = "res";
+		std::string OutputPath = "res.pack";
+		TextureCooker::Options Texture;
+		bool Compress = false;
+	};
+
+	struct Stats
+	{
+		unsigned int Loads = 0;
+		size_t BytesMapped = 0;
+		size_t BytesDecompressed = 0;
+	};
+
+	//	Returns true if the arguments ask for a pack to be built (--pack), and fills `options` from the rest of them:
+	//	--pack-root dir, --pack-out file, --lz4, and the TextureCooker's --format and --no-mips.
+	static bool ParseArgs(int argc, char** argv, Options& options);
+	static bool Build(const Options& options);
+
+	//	Maps the pack; IsOpen() is false if it can't be opened or isn't a valid pack.
+	AssetPack(const std::string& path);
+	~AssetPack();
+
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	//	The current pack, or null if assets come from the file system.
+	static AssetPack* Get();
+	static void MakeCurrent(AssetPack* pack);
+
+	inline bool IsOpen() const { return m_Data != nullptr; }
+	inline const std::string& GetPath() const { return m_Path; }
+	inline size_t GetFileSize() const { return m_Size; }
+	inline size_t GetEntryCount() const { return m_Entries.size(); }
+	inline const Stats& GetStats() const { return m_Stats; }
+
+	//	The entry of `path`, or null.
+	const Entry* Find(const std::string& path) const;
+	inline bool Contains(const std::string& path) const { return Find(path) != nullptr; }
+
+	//	False if the pack has no such entry, or it's corrupt.
+	bool Load(const std::string& path, Data& data);
+	//	Fills `texture` with pointers into `data`, which has to outlive it. False if `path` isn't a cooked texture of the pack.
+	bool LoadTexture(const std::string& path, CookedTextureView& texture, Data& data);
+
+	void OnImGuiRender() const;
+
+	//	Forward slashes and no leading "./", the way names are stored.
+	static std::string NormalizePath(const std::string& path);
+
+private:
+	bool Validate();
+	void Unmap();
+	bool Decompress(const Entry& entry, Data& data) const;
+
+private:
+	std::string m_Path;
+	const unsigned char* m_Data;
+	size_t m_Size;
+	//	The file and mapping handles on Windows.
+	void* m_File;
+	void* m_Mapping;
+
+	//	Point into the mapping.
+	std::unordered_map<std::string, const Entry*> m_Entries;
+	Stats m_Stats;
+};
@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include "Renderer.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "FrameUniforms.h"
+
+
+//  What was measured for one test.
+struct BenchmarkResult
+{
+    std::string Name;
+    std::vector<double> CpuFrameTimes;
+    bool HasGpuTime = false;
+    double GpuAvg = 0.0, GpuP99 = 0.0;
+    double DrawCalls = 0.0, Indices = 0.0;
+    double StateChangesIssued = 0.0, StateChangesSkipped = 0.0;
+};
+
+static double Percentile(const std::vector<double>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+    return sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * percentile))];
+}
+
+//  Test names come from the menu and the GL strings from the driver, so either may have quotes or backslashes.
+static void WriteEscaped(std::ostream& stream, const char* text)
+{
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            stream << '\\' << *c;
+        else if ((unsigned char)*c < 0x20)
+        {
+            const char* hex = "0123456789abcdef";
+            stream << "\\u00" << hex[(*c >> 4) & 0xf] << hex[*c & 0xf];
+        }
+        else
+            stream << *c;
+    }
+}
+
+static const char* GetGLString(GLenum name)
+{
+    const GLubyte* string = glGetString(name);
+    return string ? (const char*)string : "";
+}
+
+bool Benchmark::ParseArgs(int argc, char** argv, Options& options)
+{
+    bool bench = false;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--bench") == 0)
+            bench = true;
+        else if (std::strcmp(argv[i], "--headless") == 0)
+            options.Headless = true;
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+            options.WarmupFrames = (unsigned int)std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+            options.MeasuredFrames = (unsigned int)std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+            options.OutputPath = argv[++i];
+        else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+            options.Filter = argv[++i];
+    }
+    return bench;
+}
+
+bool Benchmark::Run(GLFWwindow* window, const test::TestMenu& menu, const Options& options)
+{
+    GpuProfiler gpuProfiler;
+    GpuProfiler::MakeCurrent(&gpuProfiler);
+
+    const float deltaTime = 1.0f / 60.0f;
+    std::vector<BenchmarkResult> results;
+
+    for (const auto& entry : menu.GetTests())
+    {
+        if (!options.Filter.empty() && entry.first.find(options.Filter) == std::string::npos)
+            continue;
+
+        std::cout << "Benchmarking " << entry.first << "...\n";
+        std::unique_ptr<test::Test> test(entry.second());
+
+        BenchmarkResult result;
+        result.Name = entry.first;
+        result.CpuFrameTimes.reserve(options.MeasuredFrames);
+
+        unsigned int totalFrames = options.WarmupFrames + options.MeasuredFrames;
+        for (unsigned int frame = 0; frame < totalFrames; frame++)
+        {
+            bool measured = frame >= options.WarmupFrames;
+            if (frame == options.WarmupFrames)
+                gpuProfiler.Reset();
+
+            Renderer::ResetDrawStats();
+            GLStateCache::Get().ResetStats();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            gpuProfiler.BeginFrame();
+            //  A fixed clock, like deltaTime, so every run draws the same frames.
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+            FrameUniforms::Get().BeginFrame(frame * deltaTime, glm::vec2((float)width, (float)height));
+            {
+                GPU_PROFILE_SCOPE("Test::OnRender");
+                test->OnUpdate(deltaTime);
+                test->OnRender();
+            }
+            gpuProfiler.EndFrame();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            if (measured)
+            {
+                result.CpuFrameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                result.DrawCalls += Renderer::GetDrawStats().DrawCalls;
+                result.Indices += (double)Renderer::GetDrawStats().Indices;
+                result.StateChangesIssued += (double)GLStateCache::Get().GetStats().Issued;
+                result.StateChangesSkipped += (double)GLStateCache::Get().GetStats().Skipped;
+            }
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+
+        //  The last frames' GPU times are still in flight; empty frames read them back without adding new samples.
+        GLCall(glFinish());
+        for (unsigned int i = 0; i < GpuProfiler::FrameLatency; i++)
+        {
+            gpuProfiler.BeginFrame();
+            gpuProfiler.EndFrame();
+        }
+
+        for (const GpuProfiler::ScopeStats& stats : gpuProfiler.GetStats())
+        {
+            if (stats.Name == "Test::OnRender")
+            {
+                result.HasGpuTime = true;
+                result.GpuAvg = stats.Avg;
+                result.GpuP99 = stats.P99;
+            }
+        }
+
+        double frames = (double)options.MeasuredFrames;
+        result.DrawCalls /= frames;
+        result.Indices /= frames;
+        result.StateChangesIssued /= frames;
+        result.StateChangesSkipped /= frames;
+        results.push_back(result);
+
+        //  Whatever the test left bound is deleted with it.
+        test.reset();
+        GLStateCache::Get().Invalidate();
+    }
+
+    GpuProfiler::MakeCurrent(nullptr);
+
+    std::ofstream stream(options.OutputPath);
+    if (!stream)
+    {
+        std::cout << "Could not write " << options.OutputPath << "\n";
+        return false;
+    }
+
+    stream << "{\n";
+    stream << "  \"renderer\": \"";
+    WriteEscaped(stream, GetGLString(GL_RENDERER));
+    stream << "\",\n  \"version\": \"";
+    WriteEscaped(stream, GetGLString(GL_VERSION));
+    stream << "\",\n";
+    stream << "  \"warmupFrames\": " << options.WarmupFrames << ",\n";
+    stream << "  \"measuredFrames\": " << options.MeasuredFrames << ",\n";
+    stream << "  \"tests\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+        std::vector<double> sorted = result.CpuFrameTimes;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double time : sorted)
+            sum += time;
+
+        stream << (i ? ",\n" : "\n") << "    {\n";
+        stream << "      \"name\": \"";
+        WriteEscaped(stream, result.Name.c_str());
+        stream << "\",\n";
+        stream << "      \"cpu\": { \"minMs\": " << sorted.front() << ", \"avgMs\": " << sum / sorted.size()
+            << ", \"p50Ms\": " << Percentile(sorted, 0.5) << ", \"p99Ms\": " << Percentile(sorted, 0.99)
+            << ", \"maxMs\": " << sorted.back() << " },\n";
+        if (result.HasGpuTime)
+            stream << "      \"gpu\": { \"avgMs\": " << result.GpuAvg << ", \"p99Ms\": " << result.GpuP99 << " },\n";
+        else
+            stream << "      \"gpu\": null,\n";
+        stream << "      \"draws\": { \"drawCalls\": " << result.DrawCalls << ", \"indices\": " << result.Indices
+            << ", \"stateChangesIssued\": " << result.StateChangesIssued
+            << ", \"stateChangesSkipped\": " << result.StateChangesSkipped << " }\n";
+        stream << "    }";
+    }
+    stream << "\n  ]\n}\n";
+
+    std::cout << "Wrote " << options.OutputPath << "\n";
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tests/Test.h"
+
+struct GLFWwindow;
+
+/**
+*	Runs every test registered in a TestMenu without the UI and writes how long each one takes as JSON.
+*
+*	Each test is created, given WarmupFrames frames to settle (shader compiles, first uploads, driver caches), then
+*	MeasuredFrames frames are timed. The window is expected to have vsync off, so the numbers are how long a frame
+*	takes and not how long the monitor takes to ask for the next one. OnUpdate gets a fixed 1/60 s so every
+*	run does the same work.
+*
+*	For each test, the JSON has:
+*		cpu:	the time from the start of OnUpdate to the end of OnRender, in ms (min, avg, p50, p99, max).
+*		gpu:	the time the GPU spent on OnRender, from the GpuProfiler, in ms (avg, p99); null without timer queries.
+*		draws:	draw calls and indices per frame through the Renderer, and GL state changes issued/skipped per frame.
+*/
+class Benchmark
+{
+public:
+	struct Options
+	{
+		unsigned int WarmupFrames = 30;
+		unsigned int MeasuredFrames = 300;
+		std::string OutputPath = "bench.json";
+		//	Only tests whose name contains this are run; empty runs all of them.
+		std::string Filter;
+		//	Make the context with OSMesa on GLFW's null platform, e.g. on a machine with no GPU or display.
+		//	Only in a build with an OSMesa GLEW (GLEW_OSMESA defined); otherwise the program refuses to start.
+		bool Headless = false;
+	};
+
+	//	Returns true if the arguments ask for a benchmark (--bench), and fills `options` from the rest of them:
+	//	--warmup N, --frames N, --out file, --filter text, --headless.
+	static bool ParseArgs(int argc, char** argv, Options& options);
+
+	//	Needs the GL context current, with GLEW and the state cache set up. Returns false if the output can't be written.
+	static bool Run(GLFWwindow* window, const test::TestMenu& menu, const Options& options);
+};
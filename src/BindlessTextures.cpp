@@ -0,0 +1,62 @@
+#include "BindlessTextures.h"
+
+#include "Renderer.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+
+//  Texture name to its resident handle.
+static std::unordered_map<unsigned int, GLuint64> s_Handles;
+//  The textures that will still be re-specified, which a handle would make immutable.
+static std::unordered_set<unsigned int> s_Streaming;
+
+
+bool BindlessTextures::IsSupported()
+{
+    return GLEW_VERSION_4_3 && GLEW_ARB_bindless_texture;
+}
+
+GLuint64 BindlessTextures::GetHandle(unsigned int texture)
+{
+    auto it = s_Handles.find(texture);
+    if (it != s_Handles.end())
+        return it->second;
+
+    ASSERT(IsSupported());
+    ASSERT(!IsStreaming(texture));
+    GLuint64 handle = 0;
+    GLCall(handle = glGetTextureHandleARB(texture));
+    GLCall(glMakeTextureHandleResidentARB(handle));
+
+    s_Handles[texture] = handle;
+    return handle;
+}
+
+void BindlessTextures::Release(unsigned int texture)
+{
+    auto it = s_Handles.find(texture);
+    if (it == s_Handles.end())
+        return;
+
+    GLCall(glMakeTextureHandleNonResidentARB(it->second));
+    s_Handles.erase(it);
+}
+
+void BindlessTextures::SetStreaming(unsigned int texture, bool streaming)
+{
+    if (streaming)
+        s_Streaming.insert(texture);
+    else
+        s_Streaming.erase(texture);
+}
+
+bool BindlessTextures::IsStreaming(unsigned int texture)
+{
+    return !s_Streaming.empty() && s_Streaming.count(texture) != 0;
+}
+
+unsigned int BindlessTextures::GetResidentCount()
+{
+    return (unsigned int)s_Handles.size();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/**
+*	Hands out resident ARB_bindless_texture handles for textures.
+*
+*	A handle is a 64-bit value a shader can sample through without the texture being bound to any unit,
+*	so a batch can use as many textures as it likes. The first GetHandle() of a texture creates its handle and
+*	makes it resident; the same handle is returned after that.
+*
+*	Once a texture has had a handle, its storage and sampling parameters can't be changed until it's deleted, even
+*	after Release(): the texture is immutable from the first glGetTextureHandleARB on. So a texture that's still
+*	streaming in (its real size isn't known yet) is marked with SetStreaming(), must not be given a handle, and is
+*	drawn with another texture until it's done. A resident handle must not outlive its texture, so whatever deletes
+*	a texture calls Release() first.
+*/
+class BindlessTextures
+{
+public:
+	//	ARB_bindless_texture, on a 4.3 context for the shader storage buffers the handles are read from.
+	static bool IsSupported();
+
+	//	Not for a texture that IsStreaming().
+	static GLuint64 GetHandle(unsigned int texture);
+	//	Makes the texture's handle non-resident, if it has one.
+	static void Release(unsigned int texture);
+
+	//	Called by Texture while a TextureLoad::Async texture waits for its pixels.
+	static void SetStreaming(unsigned int texture, bool streaming);
+	static bool IsStreaming(unsigned int texture);
+
+	//	How many textures currently have a resident handle.
+	static unsigned int GetResidentCount();
+};
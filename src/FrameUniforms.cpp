@@ -0,0 +1,63 @@
+#include "FrameUniforms.h"
+
+#include <cstddef>
+
+#include "Renderer.h"
+
+
+static thread_local FrameUniforms* s_Current = nullptr;
+
+const char* const FrameUniforms::BlockName = "Frame";
+
+//  Has to match the block in res/shaders/include/Frame.glsl.
+static_assert(offsetof(FrameUniforms::Data, Time) == 192, "std140 puts Time after the three matrices");
+static_assert(offsetof(FrameUniforms::Data, Viewport) == 200, "std140 aligns a vec2 to 8 bytes");
+static_assert(sizeof(FrameUniforms::Data) == 208, "FrameUniforms::Data doesn't match the std140 layout of the Frame block");
+
+FrameUniforms::FrameUniforms()
+    : m_Buffer(std::make_unique<UniformBuffer>((unsigned int)sizeof(Data), Binding))
+{
+    m_Buffer->SetData(&m_Data, sizeof(Data));
+    m_Stats.Uploads++;
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    if (s_Current == this)
+        s_Current = nullptr;
+}
+
+FrameUniforms& FrameUniforms::Get()
+{
+    ASSERT(s_Current);
+    return *s_Current;
+}
+
+void FrameUniforms::MakeCurrent(FrameUniforms* frame)
+{
+    s_Current = frame;
+}
+
+void FrameUniforms::BeginFrame(float time, const glm::vec2& viewport)
+{
+    m_Data.Time = time;
+    m_Data.Viewport = viewport;
+    //  Just the tail of the block; the matrices are SetCamera()'s.
+    m_Buffer->SetData(&m_Data.Time, sizeof(Data) - offsetof(Data, Time), offsetof(Data, Time));
+    m_Stats.Uploads++;
+}
+
+void FrameUniforms::SetCamera(const glm::mat4& view, const glm::mat4& projection)
+{
+    if (view == m_Data.View && projection == m_Data.Projection)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+
+    m_Data.View = view;
+    m_Data.Projection = projection;
+    m_Data.ViewProjection = projection * view;
+    m_Buffer->SetData(&m_Data, offsetof(Data, Time));
+    m_Stats.Uploads++;
+}
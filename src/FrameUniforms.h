@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+
+#include "glm/glm.hpp"
+#include "UniformBuffer.h"
+
+/**
+*	The uniforms that are the same for every draw of a frame, in one std140 block at a fixed binding point that the
+*	shaders read through res/shaders/include/Frame.glsl: the camera, the time and the size of the viewport.
+*
+*	Before, every draw set its own u_MVP, which is a GetUniformLocation() (a std::string hash) and a
+*	glUniformMatrix4fv per draw and per shader. The camera is now uploaded once a frame, whichever shaders draw
+*	with it; a draw only sets the model matrix, or nothing for batches whose vertices are already in world space.
+*
+*	App calls BeginFrame() once a frame and a test calls SetCamera() before drawing. Shader binds the Frame block
+*	of every program it makes to Binding, so no program has to be told about the buffer.
+*/
+class FrameUniforms
+{
+public:
+	static const unsigned int Binding = 0;
+	static const char* const BlockName;
+
+	//	The block's std140 layout: the matrices take 64 bytes each, and vec2 is aligned to 8 bytes, hence Padding.
+	struct Data
+	{
+		glm::mat4 View = glm::mat4(1.0f);
+		glm::mat4 Projection = glm::mat4(1.0f);
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+		//	Seconds since the app started.
+		float Time = 0.0f;
+		float Padding = 0.0f;
+		//	In pixels.
+		glm::vec2 Viewport = glm::vec2(0.0f);
+	};
+
+	struct Stats
+	{
+		//	glBufferSubData calls, and SetCamera() calls that didn't need one since the camera didn't move.
+		unsigned long long Uploads = 0;
+		unsigned long long Skipped = 0;
+	};
+
+	//	Needs a context.
+	FrameUniforms();
+	~FrameUniforms();
+
+	FrameUniforms(const FrameUniforms&) = delete;
+	FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+	//	The block of this thread's context; there must be one.
+	static FrameUniforms& Get();
+	static void MakeCurrent(FrameUniforms* frame);
+
+	void BeginFrame(float time, const glm::vec2& viewport);
+	//	Uploads the matrices only if they changed.
+	void SetCamera(const glm::mat4& view, const glm::mat4& projection);
+
+	inline const Data& GetData() const { return m_Data; }
+	inline const Stats& GetStats() const { return m_Stats; }
+
+private:
+	std::unique_ptr<UniformBuffer> m_Buffer;
+	Data m_Data;
+	Stats m_Stats;
+};
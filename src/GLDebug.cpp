@@ -0,0 +1,90 @@
+#include "GLDebug.h"
+
+#include <iostream>
+
+
+GLDebug::Mode GLDebug::s_Mode = GLDebug::Mode::GetError;
+bool GLDebug::s_Synchronous = true;
+GLCallSite GLDebug::s_LastCall = { "", "", 0 };
+bool GLDebug::s_ErrorRaised = false;
+unsigned int GLDebug::s_MessageCount = 0;
+
+
+//  This just retrieves and clears all error flags
+void GLClearError()
+{
+    //  Can be written as `while (glGetError() != GL_NO_ERROR);`
+    //  It keeps retrieving errors and clearing the flags until there are no more errors
+    while (glGetError());
+}
+
+bool GLLogCall(const char* functionName, const char* fileName, int line)
+{
+    //  The below checks for an error and since it returns a GLenum (same as an unsigned int enum)
+    //  this assignes the value to the variable 'error'.
+    //  It gets the error as long as the 'error' value gotten is not 0
+    while (GLenum error = glGetError())
+    {
+        std::cout << "[OpenGL Error] (" << error << "): " << functionName << " " << fileName << ":" << line << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool GLDebug::IsCallbackSupported()
+{
+    return GLEW_VERSION_4_3 || GLEW_KHR_debug;
+}
+
+GLDebug::Mode GLDebug::SetMode(Mode mode, bool synchronous)
+{
+    if (mode == Mode::Callback && !IsCallbackSupported())
+        mode = Mode::GetError;
+
+    if (mode == Mode::Callback)
+    {
+        s_Synchronous = synchronous;
+        glEnable(GL_DEBUG_OUTPUT);
+        if (synchronous)
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        else
+            glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageCallback(OnDebugMessage, nullptr);
+        //  Notifications (e.g. "buffer will use video memory") come every frame on some drivers and aren't problems.
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+    }
+    else if (IsCallbackSupported())
+    {
+        glDebugMessageCallback(nullptr, nullptr);
+        glDisable(GL_DEBUG_OUTPUT);
+    }
+
+    //  Errors raised while in the old mode shouldn't be blamed on the first call in the new one.
+    while (glGetError());
+    s_ErrorRaised = false;
+    s_Mode = mode;
+    return mode;
+}
+
+void GLAPIENTRY GLDebug::OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+{
+    (void)source; (void)length; (void)userParam;
+    s_MessageCount++;
+
+    const char* kind = "Message";
+    switch (type)
+    {
+        case GL_DEBUG_TYPE_ERROR:               kind = "Error"; break;
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: kind = "Deprecated"; break;
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  kind = "Undefined Behavior"; break;
+        case GL_DEBUG_TYPE_PERFORMANCE:         kind = "Performance"; break;
+    }
+
+    //  Asynchronous messages only know the last call made, not necessarily the one that caused it.
+    std::cout << "[OpenGL " << kind << "] (" << id << "): " << message << "\n"
+        << "    " << (s_Synchronous ? "at " : "near ") << s_LastCall.Function << " " << s_LastCall.File << ":" << s_LastCall.Line << "\n";
+
+    //  Only a synchronous message is known to belong to the call GLCall is in, so only then does GLCall break on it.
+    if (s_Synchronous && (type == GL_DEBUG_TYPE_ERROR || severity == GL_DEBUG_SEVERITY_HIGH))
+        s_ErrorRaised = true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#if defined(_MSC_VER)
+	#define DEBUG_BREAK() __debugbreak()
+#else
+	#define DEBUG_BREAK() __builtin_trap()
+#endif
+
+#define ASSERT(x) if (!(x)) DEBUG_BREAK();
+
+/**
+*	GLCall wraps every GL call so errors are reported with the call, file and line they came from.
+*
+*	How the errors are found is chosen at runtime with GLDebug::SetMode():
+*		GetError:	glGetError() before and after every call. Exact, but those are two round trips to the driver
+*					per call, which on many drivers stops it from running ahead of the application.
+*		Callback:	the driver reports errors itself through glDebugMessageCallback (KHR_debug / 4.3), and GLCall
+*					only remembers which call it's at, which costs a few stores. See GLDebug.
+*		Off:		nothing is checked; for measuring what the checking costs, or with a no-error context.
+*
+*	In release builds (NDEBUG) GLCall is just the call.
+*/
+#ifdef NDEBUG
+	#define GLCall(x) x
+#else
+	#define GLCall(x) GLBeginCall(#x, __FILE__, __LINE__);\
+		x;\
+		ASSERT(GLEndCall(#x, __FILE__, __LINE__))
+#endif
+
+
+//  This just retrieves and clears all error flags
+void GLClearError();
+
+bool GLLogCall(const char* functionName, const char* fileName, int line);
+
+//	The GL call GLCall is at; in Callback mode this is all the callback has to say where a message came from.
+struct GLCallSite
+{
+	const char* Function;
+	const char* File;
+	int Line;
+};
+
+class GLDebug
+{
+public:
+	enum class Mode
+	{
+		GetError = 0, Callback = 1, Off = 2
+	};
+
+	//	Whether glDebugMessageCallback is there at all. Messages are only guaranteed in a debug context.
+	static bool IsCallbackSupported();
+
+	/**
+	*	Switches mode; Callback installs the debug message callback, and falls back to GetError if it isn't supported.
+	*	With `synchronous`, the driver calls the callback from inside the GL call that caused the message, so the
+	*	breadcrumb is exact and GLCall can break right at it. Without, messages may arrive later (or from the
+	*	driver's thread), so the breadcrumb only says roughly where the program was.
+	*/
+	static Mode SetMode(Mode mode, bool synchronous = true);
+	inline static Mode GetMode() { return s_Mode; }
+
+	inline static void SetLastCall(const char* function, const char* file, int line) { s_LastCall = { function, file, line }; }
+	inline static const GLCallSite& GetLastCall() { return s_LastCall; }
+
+	//	Set by the callback when a message is an error; GLCall clears it before the call and checks it after.
+	inline static bool TakeError() { bool error = s_ErrorRaised; s_ErrorRaised = false; return error; }
+	inline static unsigned int GetMessageCount() { return s_MessageCount; }
+
+private:
+	static void GLAPIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
+
+private:
+	static Mode s_Mode;
+	static bool s_Synchronous;
+	static GLCallSite s_LastCall;
+	static bool s_ErrorRaised;
+	static unsigned int s_MessageCount;
+};
+
+inline void GLBeginCall(const char* functionName, const char* fileName, int line)
+{
+	if (GLDebug::GetMode() == GLDebug::Mode::Callback)
+	{
+		//	An error from a call that isn't wrapped (ImGui's backend, a sync object) isn't this call's.
+		GLDebug::TakeError();
+		GLDebug::SetLastCall(functionName, fileName, line);
+	}
+	else if (GLDebug::GetMode() == GLDebug::Mode::GetError)
+		GLClearError();
+}
+
+inline bool GLEndCall(const char* functionName, const char* fileName, int line)
+{
+	if (GLDebug::GetMode() == GLDebug::Mode::Callback)
+		return !GLDebug::TakeError();
+	if (GLDebug::GetMode() == GLDebug::Mode::GetError)
+		return GLLogCall(functionName, fileName, line);
+	return true;
+}
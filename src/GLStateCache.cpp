@@ -0,0 +1,227 @@
+#include "GLStateCache.h"
+
+#include "Renderer.h"
+
+//  Stands for "don't know what is bound"; never a valid object name in practice.
+static const unsigned int s_Unknown = 0xffffffff;
+
+static GLStateCache s_DefaultCache;
+static thread_local GLStateCache* s_CurrentCache = nullptr;
+
+
+GLStateCache::GLStateCache()
+{
+    Invalidate();
+}
+
+GLStateCache& GLStateCache::Get()
+{
+    return s_CurrentCache ? *s_CurrentCache : s_DefaultCache;
+}
+
+void GLStateCache::MakeCurrent(GLStateCache* cache)
+{
+    s_CurrentCache = cache;
+}
+
+bool GLStateCache::Set(unsigned int& current, unsigned int value)
+{
+    if (current == value)
+    {
+        m_Stats.Skipped++;
+        return true;
+    }
+
+    current = value;
+    m_Stats.Issued++;
+    return false;
+}
+
+void GLStateCache::UseProgram(unsigned int program)
+{
+    if (Set(m_Program, program))
+        return;
+
+    GLCall(glUseProgram(program));
+}
+
+void GLStateCache::BindVertexArray(unsigned int vao)
+{
+    if (Set(m_VertexArray, vao))
+        return;
+
+    GLCall(glBindVertexArray(vao));
+
+    auto it = m_VertexArrayElementBuffers.find(vao);
+    m_ElementBuffer = it != m_VertexArrayElementBuffers.end() ? it->second : s_Unknown;
+}
+
+void GLStateCache::BindBuffer(unsigned int target, unsigned int buffer)
+{
+    if (target == GL_ARRAY_BUFFER)
+    {
+        if (Set(m_ArrayBuffer, buffer))
+            return;
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        if (Set(m_ElementBuffer, buffer))
+            return;
+
+        if (m_VertexArray != s_Unknown)
+            m_VertexArrayElementBuffers[m_VertexArray] = buffer;
+    }
+    else
+    {
+        m_Stats.Issued++;
+    }
+
+    GLCall(glBindBuffer(target, buffer));
+}
+
+void GLStateCache::ActiveTexture(unsigned int unit)
+{
+    ASSERT(unit < MaxTextureUnits);
+
+    if (Set(m_ActiveTexture, unit))
+        return;
+
+    GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+}
+
+void GLStateCache::BindTexture(unsigned int target, unsigned int texture)
+{
+    std::array<unsigned int, MaxTextureUnits>* bindings = GetTextureBindings(target);
+    if (bindings && m_ActiveTexture != s_Unknown)
+    {
+        if (Set((*bindings)[m_ActiveTexture], texture))
+            return;
+    }
+    else
+    {
+        if (bindings)
+            bindings->fill(s_Unknown);
+        m_Stats.Issued++;
+    }
+
+    GLCall(glBindTexture(target, texture));
+}
+
+void GLStateCache::BindTextureUnit(unsigned int unit, unsigned int texture)
+{
+    BindTextureUnit(unit, texture, GL_TEXTURE_2D);
+}
+
+void GLStateCache::BindTextureUnit(unsigned int unit, unsigned int texture, unsigned int target)
+{
+    ASSERT(unit < MaxTextureUnits);
+
+    std::array<unsigned int, MaxTextureUnits>* bindings = GetTextureBindings(target);
+    if (bindings && (*bindings)[unit] == texture)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+
+    ActiveTexture(unit);
+    BindTexture(target, texture);
+}
+
+std::array<unsigned int, GLStateCache::MaxTextureUnits>* GLStateCache::GetTextureBindings(unsigned int target)
+{
+    if (target == GL_TEXTURE_2D)
+        return &m_Textures2D;
+    if (target == GL_TEXTURE_2D_ARRAY)
+        return &m_Textures2DArray;
+    return nullptr;
+}
+
+void GLStateCache::SetBlend(bool enabled)
+{
+    if (Set(m_Blend, enabled ? 1u : 0u))
+        return;
+
+    if (enabled)
+    {
+        GLCall(glEnable(GL_BLEND));
+    }
+    else
+    {
+        GLCall(glDisable(GL_BLEND));
+    }
+}
+
+void GLStateCache::BlendFunc(unsigned int source, unsigned int destination)
+{
+    if (m_BlendSource == source && m_BlendDestination == destination)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+
+    m_BlendSource = source;
+    m_BlendDestination = destination;
+    m_Stats.Issued++;
+    GLCall(glBlendFunc(source, destination));
+}
+
+void GLStateCache::OnDeleteProgram(unsigned int program)
+{
+    //  Deleting the program in use doesn't unbind it, but its name can be reused once it is no longer in use.
+    if (m_Program == program)
+        m_Program = s_Unknown;
+}
+
+void GLStateCache::OnDeleteVertexArray(unsigned int vao)
+{
+    //  Deleting the bound vertex array binds 0 instead.
+    if (m_VertexArray == vao)
+    {
+        m_VertexArray = 0;
+        m_ElementBuffer = s_Unknown;
+    }
+    m_VertexArrayElementBuffers.erase(vao);
+}
+
+void GLStateCache::OnDeleteBuffer(unsigned int buffer)
+{
+    if (m_ArrayBuffer == buffer)
+        m_ArrayBuffer = 0;
+    if (m_ElementBuffer == buffer)
+        m_ElementBuffer = 0;
+
+    for (auto& binding : m_VertexArrayElementBuffers)
+    {
+        if (binding.second == buffer)
+            binding.second = s_Unknown;
+    }
+}
+
+void GLStateCache::OnDeleteTexture(unsigned int texture)
+{
+    for (unsigned int& bound : m_Textures2D)
+    {
+        if (bound == texture)
+            bound = 0;
+    }
+    for (unsigned int& bound : m_Textures2DArray)
+    {
+        if (bound == texture)
+            bound = 0;
+    }
+}
+
+void GLStateCache::Invalidate()
+{
+    m_Program = s_Unknown;
+    m_VertexArray = s_Unknown;
+    m_ArrayBuffer = s_Unknown;
+    m_ElementBuffer = s_Unknown;
+    m_VertexArrayElementBuffers.clear();
+    m_ActiveTexture = s_Unknown;
+    m_Textures2D.fill(s_Unknown);
+    m_Textures2DArray.fill(s_Unknown);
+    m_Blend = s_Unknown;
+    m_BlendSource = s_Unknown;
+    m_BlendDestination = s_Unknown;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+
+/**
+*	Remembers what is currently bound in the OpenGL context so binds that wouldn't change anything are skipped.
+*
+*	OpenGL is a state machine, and e.g. glUseProgram with the program that is already in use still goes
+*	through the driver. Renderer::Draw binds the shader, vertex array and index buffer every time, and the tests
+*	bind the shader again right before it, so most of those calls are for nothing.
+*	All the wrappers (Shader, VertexArray, VertexBuffer, IndexBuffer, Texture...) bind through here instead of
+*	calling GL themselves.
+*
+*	The cache is only correct as long as nothing else changes the same state behind its back. Code that calls
+*	GL directly (ImGui's renderer, for example) must be followed by Invalidate(), which makes the next bind of
+*	everything go through to GL again.
+*
+*	One cache is kept per context; MakeCurrent() is called next to glfwMakeContextCurrent() when there is more than one.
+*/
+class GLStateCache
+{
+public:
+	struct Stats
+	{
+		//	Calls that reached GL, and calls that were skipped because the state was already set.
+		unsigned long long Issued = 0;
+		unsigned long long Skipped = 0;
+	};
+
+	//	The number of texture units that are tracked; GL_TEXTURE0 to GL_TEXTURE31.
+	static const unsigned int MaxTextureUnits = 32;
+
+	GLStateCache();
+
+	//	The cache of the context that is current on this thread.
+	static GLStateCache& Get();
+	static void MakeCurrent(GLStateCache* cache);
+
+	void UseProgram(unsigned int program);
+	void BindVertexArray(unsigned int vao);
+	//	GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached, any other target always goes through.
+	void BindBuffer(unsigned int target, unsigned int buffer);
+	//	`unit` is the slot number (0, 1, 2...), not GL_TEXTURE0 + slot.
+	void ActiveTexture(unsigned int unit);
+	//	Binds to the active texture unit.
+	void BindTexture(unsigned int target, unsigned int texture);
+	//	Binds a 2D texture to a unit, without the caller having to care which unit is active.
+	void BindTextureUnit(unsigned int unit, unsigned int texture);
+	//	The same for any texture target; GL_TEXTURE_2D and GL_TEXTURE_2D_ARRAY are cached.
+	void BindTextureUnit(unsigned int unit, unsigned int texture, unsigned int target);
+	void SetBlend(bool enabled);
+	void BlendFunc(unsigned int source, unsigned int destination);
+
+	//	Called when an object is deleted, since GL hands the same names out again afterwards.
+	void OnDeleteProgram(unsigned int program);
+	void OnDeleteVertexArray(unsigned int vao);
+	void OnDeleteBuffer(unsigned int buffer);
+	void OnDeleteTexture(unsigned int texture);
+
+	//	Forgets everything, so the next call of each kind reaches GL.
+	void Invalidate();
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+
+private:
+	//	Returns true if `current` already is `value`; otherwise sets it and counts the call as issued.
+	bool Set(unsigned int& current, unsigned int value);
+	//	What is bound to `target` on each unit, or null for targets that aren't cached.
+	std::array<unsigned int, MaxTextureUnits>* GetTextureBindings(unsigned int target);
+
+private:
+	unsigned int m_Program;
+	unsigned int m_VertexArray;
+	unsigned int m_ArrayBuffer;
+	//	The element buffer binding is part of the vertex array's state, so it is remembered per vertex array.
+	unsigned int m_ElementBuffer;
+	std::unordered_map<unsigned int, unsigned int> m_VertexArrayElementBuffers;
+
+	unsigned int m_ActiveTexture;
+	std::array<unsigned int, MaxTextureUnits> m_Textures2D;
+	std::array<unsigned int, MaxTextureUnits> m_Textures2DArray;
+
+	unsigned int m_Blend;
+	unsigned int m_BlendSource, m_BlendDestination;
+
+	Stats m_Stats;
+};
@@ -0,0 +1,282 @@
+#include "GpuProfiler.h"
+
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <fstream>
+
+static thread_local GpuProfiler* s_CurrentProfiler = nullptr;
+
+
+GpuProfiler::GpuProfiler()
+    : m_Supported(false), m_InFrame(false), m_FrameIndex(0), m_Generation(0), m_DroppedFrames(0)
+{
+    //  Timer queries are core since 3.3, but a driver may still have no counter behind them.
+    int counterBits = 0;
+    GLCall(glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits));
+    m_Supported = counterBits > 0;
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    if (s_CurrentProfiler == this)
+        s_CurrentProfiler = nullptr;
+
+    for (Frame& frame : m_Frames)
+    {
+        if (!frame.Queries.empty())
+        {
+            GLCall(glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data()));
+        }
+    }
+}
+
+GpuProfiler* GpuProfiler::Get()
+{
+    return s_CurrentProfiler;
+}
+
+void GpuProfiler::MakeCurrent(GpuProfiler* profiler)
+{
+    s_CurrentProfiler = profiler;
+}
+
+void GpuProfiler::BeginFrame()
+{
+    ASSERT(!m_InFrame);
+    if (!m_Supported)
+        return;
+
+    m_FrameIndex = (m_FrameIndex + 1) % FrameLatency;
+    //  This set was last used FrameLatency frames ago, so its results should be in by now.
+    CollectFrame(m_Frames[m_FrameIndex]);
+    m_Frames[m_FrameIndex].Generation = m_Generation;
+    m_InFrame = true;
+}
+
+void GpuProfiler::EndFrame()
+{
+    if (!m_InFrame)
+        return;
+
+    //  Scopes still open at the end of the frame are closed here, so their queries are never left without an end.
+    while (!m_Frames[m_FrameIndex].OpenScopes.empty())
+        EndScope();
+    m_InFrame = false;
+}
+
+void GpuProfiler::BeginScope(const char* name)
+{
+    if (!m_InFrame)
+        return;
+
+    Frame& frame = m_Frames[m_FrameIndex];
+
+    PendingScope scope;
+    scope.Name = name;
+    scope.Depth = (unsigned int)frame.OpenScopes.size();
+    scope.BeginQuery = AcquireQuery();
+    scope.EndQuery = 0;
+    GLCall(glQueryCounter(scope.BeginQuery, GL_TIMESTAMP));
+
+    frame.OpenScopes.push_back((unsigned int)frame.Scopes.size());
+    frame.Scopes.push_back(scope);
+}
+
+void GpuProfiler::EndScope()
+{
+    if (!m_InFrame)
+        return;
+
+    Frame& frame = m_Frames[m_FrameIndex];
+    ASSERT(!frame.OpenScopes.empty());
+
+    PendingScope& scope = frame.Scopes[frame.OpenScopes.back()];
+    frame.OpenScopes.pop_back();
+    scope.EndQuery = AcquireQuery();
+    GLCall(glQueryCounter(scope.EndQuery, GL_TIMESTAMP));
+}
+
+unsigned int GpuProfiler::AcquireQuery()
+{
+    Frame& frame = m_Frames[m_FrameIndex];
+    if (frame.UsedQueries == frame.Queries.size())
+    {
+        unsigned int query = 0;
+        GLCall(glGenQueries(1, &query));
+        frame.Queries.push_back(query);
+    }
+    return frame.Queries[frame.UsedQueries++];
+}
+
+void GpuProfiler::CollectFrame(Frame& frame)
+{
+    //  A frame from before the last Reset() still gives its queries back, but no samples.
+    if (!frame.Scopes.empty() && frame.Generation == m_Generation)
+    {
+        //  The queries finish in order, so if the last one is ready all of them are.
+        int available = 0;
+        GLCall(glGetQueryObjectiv(frame.Scopes.back().EndQuery, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            m_DroppedFrames++;
+        else
+        {
+            //  Adds the scopes that ran more than once this frame together, in the order they were first seen.
+            std::vector<unsigned int> touched;
+            std::vector<double> totals(m_History.size(), 0.0);
+            std::vector<unsigned int> calls(m_History.size(), 0);
+
+            for (const PendingScope& scope : frame.Scopes)
+            {
+                GLuint64 begin = 0, end = 0;
+                GLCall(glGetQueryObjectui64v(scope.BeginQuery, GL_QUERY_RESULT, &begin));
+                GLCall(glGetQueryObjectui64v(scope.EndQuery, GL_QUERY_RESULT, &end));
+
+                auto found = m_HistoryIndex.find(scope.Name);
+                unsigned int index;
+                if (found == m_HistoryIndex.end())
+                {
+                    index = (unsigned int)m_History.size();
+                    m_HistoryIndex[scope.Name] = index;
+                    m_History.emplace_back();
+                    m_History.back().Name = scope.Name;
+                    m_History.back().Depth = scope.Depth;
+                    totals.push_back(0.0);
+                    calls.push_back(0);
+                }
+                else
+                    index = found->second;
+
+                if (calls[index] == 0)
+                    touched.push_back(index);
+                //  Timestamps are in nanoseconds.
+                totals[index] += (end - begin) / 1000000.0;
+                calls[index]++;
+            }
+
+            for (unsigned int index : touched)
+            {
+                ScopeHistory& history = m_History[index];
+                history.Calls = calls[index];
+                if (history.Samples.size() < MaxSamples)
+                    history.Samples.push_back(totals[index]);
+                else
+                {
+                    history.Samples[history.Next] = totals[index];
+                    history.Next = (history.Next + 1) % MaxSamples;
+                }
+            }
+        }
+    }
+
+    frame.UsedQueries = 0;
+    frame.Scopes.clear();
+    frame.OpenScopes.clear();
+}
+
+void GpuProfiler::Reset()
+{
+    //  The queries of the frames in flight can't be cancelled, so their results are dropped when they're collected.
+    m_Generation++;
+    m_History.clear();
+    m_HistoryIndex.clear();
+    m_DroppedFrames = 0;
+}
+
+GpuProfiler::ScopeStats GpuProfiler::MakeStats(const ScopeHistory& history) const
+{
+    ScopeStats stats;
+    stats.Name = history.Name;
+    stats.Depth = history.Depth;
+    stats.Calls = history.Calls;
+    stats.SampleCount = (unsigned int)history.Samples.size();
+    stats.Last = stats.Min = stats.Avg = stats.P99 = 0.0;
+    if (history.Samples.empty())
+        return stats;
+
+    //  The newest sample is the one before Next, or simply the last one while the ring isn't full yet.
+    unsigned int last = history.Samples.size() < MaxSamples ? (unsigned int)history.Samples.size() - 1 : (history.Next + MaxSamples - 1) % MaxSamples;
+    stats.Last = history.Samples[last];
+
+    std::vector<double> sorted = history.Samples;
+    std::sort(sorted.begin(), sorted.end());
+    stats.Min = sorted.front();
+    double sum = 0.0;
+    for (double sample : sorted)
+        sum += sample;
+    stats.Avg = sum / sorted.size();
+    stats.P99 = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+    return stats;
+}
+
+std::vector<GpuProfiler::ScopeStats> GpuProfiler::GetStats() const
+{
+    std::vector<ScopeStats> stats;
+    stats.reserve(m_History.size());
+    for (const ScopeHistory& history : m_History)
+        stats.push_back(MakeStats(history));
+    return stats;
+}
+
+void GpuProfiler::OnImGuiRender()
+{
+    if (!m_Supported)
+    {
+        ImGui::Text("GPU timer queries are not supported by this driver.");
+        return;
+    }
+
+    ImGui::Text("%-32s %5s %8s %8s %8s %8s", "Scope (ms)", "Calls", "Last", "Min", "Avg", "P99");
+    for (const ScopeStats& stats : GetStats())
+    {
+        std::string name = std::string(stats.Depth * 2, ' ') + stats.Name;
+        ImGui::Text("%-32s %5u %8.3f %8.3f %8.3f %8.3f", name.c_str(), stats.Calls, stats.Last, stats.Min, stats.Avg, stats.P99);
+    }
+    ImGui::Text("Dropped frames: %llu", m_DroppedFrames);
+
+    if (ImGui::Button("Reset"))
+        Reset();
+    ImGui::SameLine();
+    if (ImGui::Button("Save CSV"))
+        WriteCSV("gpu_profile.csv");
+    ImGui::SameLine();
+    if (ImGui::Button("Save JSON"))
+        WriteJSON("gpu_profile.json");
+}
+
+bool GpuProfiler::WriteCSV(const std::string& filePath) const
+{
+    std::ofstream stream(filePath);
+    if (!stream)
+        return false;
+
+    stream << "scope,depth,calls,samples,last_ms,min_ms,avg_ms,p99_ms\n";
+    for (const ScopeStats& stats : GetStats())
+    {
+        stream << stats.Name << "," << stats.Depth << "," << stats.Calls << "," << stats.SampleCount << ","
+            << stats.Last << "," << stats.Min << "," << stats.Avg << "," << stats.P99 << "\n";
+    }
+    return true;
+}
+
+bool GpuProfiler::WriteJSON(const std::string& filePath) const
+{
+    std::ofstream stream(filePath);
+    if (!stream)
+        return false;
+
+    //  Scope names are string literals from the code, so they don't need escaping.
+    stream << "{\n  \"droppedFrames\": " << m_DroppedFrames << ",\n  \"scopes\": [";
+    std::vector<ScopeStats> all = GetStats();
+    for (size_t i = 0; i < all.size(); i++)
+    {
+        const ScopeStats& stats = all[i];
+        stream << (i ? ",\n" : "\n") << "    { \"name\": \"" << stats.Name << "\", \"depth\": " << stats.Depth
+            << ", \"calls\": " << stats.Calls << ", \"samples\": " << stats.SampleCount
+            << ", \"lastMs\": " << stats.Last << ", \"minMs\": " << stats.Min
+            << ", \"avgMs\": " << stats.Avg << ", \"p99Ms\": " << stats.P99 << " }";
+    }
+    stream << "\n  ]\n}\n";
+    return true;
+}
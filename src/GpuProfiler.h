@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+/**
+*	Measures how long the GPU spends on parts of a frame, with timestamp queries.
+*
+*	GL calls only queue work, so timing them on the CPU says nothing about the GPU. Instead a GL_TIMESTAMP query
+*	is put at the start and the end of each scope, and the GPU writes the time when it gets to each of them.
+*	Timestamps (rather than GL_TIME_ELAPSED) are used so scopes can be nested.
+*
+*	Reading a query's result before the GPU got to it would make the CPU wait, so every frame has its own set of
+*	queries and a frame's results are only read FrameLatency frames later, when the set comes round again.
+*
+*	Each scope gets one sample per frame: if it ran more than once in the frame (e.g. a batch flushed several times),
+*	the times are added up. The last MaxSamples samples are kept for min/avg/p99.
+*
+*	Use GPU_PROFILE_SCOPE("name") in a block; the name must be a string literal (only the pointer is kept).
+*	Scopes outside BeginFrame()/EndFrame(), or with no profiler current, cost nothing.
+*/
+class GpuProfiler
+{
+public:
+	struct ScopeStats
+	{
+		std::string Name;
+		//	How many scopes it is nested in.
+		unsigned int Depth;
+		//	How many times it ran in the last frame that was read back.
+		unsigned int Calls;
+		//	In milliseconds.
+		double Last, Min, Avg, P99;
+		unsigned int SampleCount;
+	};
+
+	static const unsigned int FrameLatency = 4;
+	static const unsigned int MaxSamples = 300;
+
+	GpuProfiler();
+	~GpuProfiler();
+
+	//	The profiler that GPU_PROFILE_SCOPE goes to on this thread; can be null.
+	static GpuProfiler* Get();
+	static void MakeCurrent(GpuProfiler* profiler);
+
+	//	False when the driver has no timestamp counter (GL_QUERY_COUNTER_BITS of 0); nothing is measured then.
+	inline bool IsSupported() const { return m_Supported; }
+
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginScope(const char* name);
+	void EndScope();
+
+	//	Forgets all the samples, e.g. when another test is opened, along with those of the frames still in flight
+	//	(the current one included), which would otherwise be read back into the new ones.
+	void Reset();
+
+	//	In the order the scopes were first seen.
+	std::vector<ScopeStats> GetStats() const;
+	//	Frames whose results weren't ready when they came round again, and were thrown away rather than waited for.
+	inline unsigned long long GetDroppedFrames() const { return m_DroppedFrames; }
+
+	void OnImGuiRender();
+
+	bool WriteCSV(const std::string& filePath) const;
+	bool WriteJSON(const std::string& filePath) const;
+
+private:
+	struct PendingScope
+	{
+		const char* Name;
+		unsigned int Depth;
+		unsigned int BeginQuery;
+		unsigned int EndQuery;
+	};
+
+	struct Frame
+	{
+		std::vector<unsigned int> Queries;
+		unsigned int UsedQueries = 0;
+		std::vector<PendingScope> Scopes;
+		std::vector<unsigned int> OpenScopes;
+		//	m_Generation when the frame began; the results of frames from before a Reset() are thrown away.
+		unsigned int Generation = 0;
+	};
+
+	struct ScopeHistory
+	{
+		std::string Name;
+		unsigned int Depth = 0;
+		unsigned int Calls = 0;
+		std::vector<double> Samples;
+		//	Where the next sample goes once Samples is full; it's a ring.
+		unsigned int Next = 0;
+	};
+
+	//	Takes a query from the current frame's set, making more the first times round.
+	unsigned int AcquireQuery();
+	//	Reads back the frame's queries if they are ready and adds them to the history, then empties the frame.
+	void CollectFrame(Frame& frame);
+	ScopeStats MakeStats(const ScopeHistory& history) const;
+
+private:
+	bool m_Supported;
+	bool m_InFrame;
+	unsigned int m_FrameIndex;
+	unsigned int m_Generation;
+
+	std::array<Frame, FrameLatency> m_Frames;
+
+	std::vector<ScopeHistory> m_History;
+	std::unordered_map<std::string, unsigned int> m_HistoryIndex;
+
+	unsigned long long m_DroppedFrames;
+};
+
+/**
+*	Times the GPU work from here to the end of the C++ scope.
+*/
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(const char* name)
+		: m_Profiler(GpuProfiler::Get())
+	{
+		if (m_Profiler)
+			m_Profiler->BeginScope(name);
+	}
+
+	~GpuProfileScope()
+	{
+		if (m_Profiler)
+			m_Profiler->EndScope();
+	}
+
+private:
+	GpuProfiler* m_Profiler;
+};
+
+#define GPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define GPU_PROFILE_CONCAT(a, b) GPU_PROFILE_CONCAT_INNER(a, b)
+#define GPU_PROFILE_SCOPE(name) GpuProfileScope GPU_PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
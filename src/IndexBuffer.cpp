@@ -1,6 +1,7 @@
 #include "IndexBuffer.h"
 
 #include "Renderer.h"
+#include "GLStateCache.h"
 
 
 
@@ -11,7 +12,7 @@ IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, bool isSt
     GLCall(glGenBuffers(1, &m_Renderer_ID));
     //  Specifies what the buffer is used for
     //  binding the buffer shows it's to be used
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Renderer_ID));
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Renderer_ID);
     /**
     *   There may be a danger here, in this: 'count * sizeof(unsigned int)', because there may be a platform where
     *   the size of an unsigned int is not 32 bits. But this is almost rare.
@@ -23,23 +24,24 @@ IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, bool isSt
     }
     else
     {
-        GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_DYNAMIC_DRAW))
+        GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_DYNAMIC_DRAW));
     }
 }
 
 
 IndexBuffer::~IndexBuffer()
 {
+    GLStateCache::Get().OnDeleteBuffer(m_Renderer_ID);
     GLCall(glDeleteBuffers(1, &m_Renderer_ID));
 }
 
 void IndexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Renderer_ID));
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Renderer_ID);
 }
 
 
 void IndexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
@@ -27,4 +27,5 @@ public:
 
 	//	Getter
 	inline unsigned int GetCount() const { return m_Count; };
+	inline unsigned int GetRendererID() const { return m_Renderer_ID; }
 };
\ No newline at end of file
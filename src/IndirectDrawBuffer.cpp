@@ -0,0 +1,79 @@
+#include "IndirectDrawBuffer.h"
+
+#include "Renderer.h"
+#include "GLStateCache.h"
+
+
+IndirectDrawBuffer::IndirectDrawBuffer(unsigned int maxDraws)
+    : m_CommandBufferID(0), m_DrawDataBufferID(0), m_MaxDraws(maxDraws), m_Supported(IsSupported())
+{
+    m_Commands.reserve(maxDraws);
+    m_DrawData.reserve(maxDraws);
+
+    if (!m_Supported)
+        return;
+
+    GLCall(glGenBuffers(1, &m_CommandBufferID));
+    GLStateCache::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBufferID);
+    GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, maxDraws * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW));
+
+    GLCall(glGenBuffers(1, &m_DrawDataBufferID));
+    GLStateCache::Get().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_DrawDataBufferID);
+    GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, maxDraws * sizeof(IndirectDrawData), nullptr, GL_STREAM_DRAW));
+}
+
+IndirectDrawBuffer::~IndirectDrawBuffer()
+{
+    if (!m_Supported)
+        return;
+
+    GLStateCache::Get().OnDeleteBuffer(m_CommandBufferID);
+    GLStateCache::Get().OnDeleteBuffer(m_DrawDataBufferID);
+    GLCall(glDeleteBuffers(1, &m_CommandBufferID));
+    GLCall(glDeleteBuffers(1, &m_DrawDataBufferID));
+}
+
+bool IndirectDrawBuffer::IsSupported()
+{
+    //  Multi-draw indirect and storage buffers are core from 4.3; gl_DrawID only from 4.6, but 4.3+ drivers have the extension.
+    bool multiDraw = GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_storage_buffer_object);
+    return multiDraw && GLEW_ARB_shader_draw_parameters;
+}
+
+void IndirectDrawBuffer::Clear()
+{
+    m_Commands.clear();
+    m_DrawData.clear();
+}
+
+void IndirectDrawBuffer::Add(unsigned int indexCount, unsigned int firstIndex, int baseVertex, const glm::mat4& mvp, int texIndex)
+{
+    ASSERT(m_Commands.size() < m_MaxDraws);
+
+    //  BaseInstance isn't used to find the draw data (gl_DrawID is), but it's set to the same number anyway.
+    m_Commands.push_back({ indexCount, 1, firstIndex, baseVertex, (unsigned int)m_Commands.size() });
+    m_DrawData.push_back({ mvp, texIndex, { 0, 0, 0 } });
+}
+
+void IndirectDrawBuffer::Upload()
+{
+    if (!m_Supported || m_Commands.empty())
+        return;
+
+    //  Re-specifying the store first (orphaning) means the driver doesn't wait for last frame's draws to finish reading it.
+    GLStateCache::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBufferID);
+    GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, m_MaxDraws * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW));
+    GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_Commands.size() * sizeof(DrawElementsIndirectCommand), m_Commands.data()));
+
+    GLStateCache::Get().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_DrawDataBufferID);
+    GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, m_MaxDraws * sizeof(IndirectDrawData), nullptr, GL_STREAM_DRAW));
+    GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_DrawData.size() * sizeof(IndirectDrawData), m_DrawData.data()));
+}
+
+void IndirectDrawBuffer::Bind(unsigned int binding) const
+{
+    ASSERT(m_Supported);
+
+    GLStateCache::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBufferID);
+    GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_DrawDataBufferID));
+}
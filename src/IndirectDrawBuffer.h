@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+
+#include "glm/glm.hpp"
+
+/**
+*	The record glMultiDrawElementsIndirect reads for each draw; the layout is fixed by OpenGL.
+*/
+struct DrawElementsIndirectCommand
+{
+	unsigned int Count;
+	unsigned int InstanceCount;
+	unsigned int FirstIndex;
+	int BaseVertex;
+	unsigned int BaseInstance;
+};
+
+/**
+*	What the shader needs for each draw, read from a shader storage buffer with gl_DrawID as the index.
+*	It's laid out for std430: the struct is rounded up to a multiple of 16 bytes, hence the padding.
+*/
+struct IndirectDrawData
+{
+	glm::mat4 MVP;
+	int TexIndex;
+	int Padding[3];
+};
+
+/**
+*	Collects many draws that share one shader, vertex array and index buffer, so Renderer::DrawIndirect() can
+*	issue all of them with a single glMultiDrawElementsIndirect.
+*
+*	Each draw is a range of the index buffer (FirstIndex, Count) plus a BaseVertex, so different meshes packed
+*	in the same buffers can be drawn together. Per-draw data can't be a uniform anymore, since there's only one
+*	call, so it goes into a shader storage buffer the shader indexes with gl_DrawID (ARB_shader_draw_parameters).
+*
+*	Both buffers are rewritten every frame: Clear(), Add() the draws, Upload().
+*
+*	Without multi-draw indirect, storage buffers or gl_DrawID (any context below 4.3, e.g. macOS), the draws
+*	are still collected the same way, and Renderer::DrawIndirect() draws them one by one with `u_MVP` and
+*	`u_TexIndex` uniforms instead. The shader has to match the path; see IsSupported().
+*/
+class IndirectDrawBuffer
+{
+public:
+	IndirectDrawBuffer(unsigned int maxDraws);
+	~IndirectDrawBuffer();
+
+	//	Whether the context can take the single call path.
+	static bool IsSupported();
+
+	void Clear();
+	void Add(unsigned int indexCount, unsigned int firstIndex, int baseVertex, const glm::mat4& mvp, int texIndex);
+	//	Sends the commands and the draw data to the GPU. Does nothing on the fallback path.
+	void Upload();
+
+	//	Binds the command buffer to GL_DRAW_INDIRECT_BUFFER and the draw data to storage buffer binding `binding`.
+	void Bind(unsigned int binding = 0) const;
+
+	inline unsigned int GetDrawCount() const { return (unsigned int)m_Commands.size(); }
+	inline const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+	inline const std::vector<IndirectDrawData>& GetDrawData() const { return m_DrawData; }
+
+private:
+	unsigned int m_CommandBufferID;
+	unsigned int m_DrawDataBufferID;
+	unsigned int m_MaxDraws;
+	bool m_Supported;
+
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	std::vector<IndirectDrawData> m_DrawData;
+};
@@ -0,0 +1,164 @@
+#include "Instrumentor.h"
+
+#include <fstream>
+#include <iomanip>
+
+
+Instrumentor::Instrumentor()
+    : m_Recording(false), m_Session(0), m_SessionStart(std::chrono::steady_clock::now()), m_SessionStartTicks(Now())
+{
+}
+
+Instrumentor& Instrumentor::Get()
+{
+    static Instrumentor instance;
+    return instance;
+}
+
+void Instrumentor::BeginSession()
+{
+    //  Buffers notice the new session number and empty themselves the next time their thread records a zone.
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    m_SessionStart = std::chrono::steady_clock::now();
+    m_SessionStartTicks = Now();
+    //  Release, so a thread that sees the new session only empties its buffer after the last trace was read from it.
+    m_Session.fetch_add(1, std::memory_order_release);
+    m_Recording.store(true, std::memory_order_release);
+}
+
+Instrumentor::ThreadBuffer& Instrumentor::GetThreadBuffer()
+{
+    static thread_local ThreadBuffer* t_Buffer = nullptr;
+    if (!t_Buffer)
+    {
+        std::lock_guard<std::mutex> lock(m_BuffersMutex);
+        m_Buffers.push_back(std::make_unique<ThreadBuffer>());
+        t_Buffer = m_Buffers.back().get();
+        t_Buffer->ThreadID = (unsigned int)m_Buffers.size();
+        t_Buffer->Head = std::make_unique<Chunk>();
+        t_Buffer->Tail = t_Buffer->Head.get();
+        t_Buffer->Session.store(m_Session.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    return *t_Buffer;
+}
+
+Instrumentor::ThreadBuffer::~ThreadBuffer()
+{
+    //  The head and the spare chunks are unique_ptrs, but the rest of the chain is only linked through Next.
+    Chunk* chunk = Head ? Head->Next.load(std::memory_order_relaxed) : nullptr;
+    while (chunk)
+    {
+        Chunk* next = chunk->Next.load(std::memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+    }
+}
+
+void Instrumentor::Clear(ThreadBuffer& buffer)
+{
+    //  The chunks after the head are kept for the next session instead of being freed.
+    Chunk* chunk = buffer.Head->Next.exchange(nullptr, std::memory_order_relaxed);
+    while (chunk)
+    {
+        Chunk* next = chunk->Next.exchange(nullptr, std::memory_order_relaxed);
+        chunk->Count.store(0, std::memory_order_relaxed);
+        buffer.Spare.emplace_back(chunk);
+        chunk = next;
+    }
+    buffer.Head->Count.store(0, std::memory_order_relaxed);
+    buffer.Tail = buffer.Head.get();
+}
+
+void Instrumentor::Record(const char* name, unsigned long long start, unsigned long long end)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+
+    unsigned int session = m_Session.load(std::memory_order_acquire);
+    if (buffer.Session.load(std::memory_order_relaxed) != session)
+    {
+        Clear(buffer);
+        //  EndSession() only walks the chain once it sees the new session, and so only after it's emptied.
+        buffer.Session.store(session, std::memory_order_release);
+    }
+
+    Chunk* tail = buffer.Tail;
+    unsigned int count = tail->Count.load(std::memory_order_relaxed);
+    if (count == ChunkSize)
+    {
+        Chunk* chunk;
+        if (!buffer.Spare.empty())
+        {
+            chunk = buffer.Spare.back().release();
+            buffer.Spare.pop_back();
+        }
+        else
+            chunk = new Chunk();
+
+        tail->Next.store(chunk, std::memory_order_release);
+        buffer.Tail = tail = chunk;
+        count = 0;
+    }
+
+    ProfileEvent& event = tail->Events[count];
+    event.Name = name;
+    event.Start = start;
+    event.Duration = end - start;
+    //  Publishes the event; whoever reads Count with acquire sees it fully written.
+    tail->Count.store(count + 1, std::memory_order_release);
+}
+
+//  Function signatures can have quotes in them (e.g. operator""), which would break the JSON.
+static void WriteEscaped(std::ostream& stream, const char* text)
+{
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            stream << '\\';
+        stream << *c;
+    }
+}
+
+bool Instrumentor::EndSession(const std::string& filePath)
+{
+    m_Recording.store(false, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    unsigned int session = m_Session.load(std::memory_order_relaxed);
+
+    //  How many microseconds one tick is, measured over the whole session.
+    double sessionTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_SessionStart).count();
+    unsigned long long sessionTicks = Now() - m_SessionStartTicks;
+    double microsecondsPerTick = sessionTicks ? sessionTime / (double)sessionTicks : 0.0;
+
+    std::ofstream stream(filePath);
+    if (!stream)
+        return false;
+
+    //  The trace format wants microseconds.
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"otherData\": {},\"traceEvents\":[";
+
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : m_Buffers)
+    {
+        if (buffer->Session.load(std::memory_order_acquire) != session)
+            continue;
+
+        for (Chunk* chunk = buffer->Head.get(); chunk; chunk = chunk->Next.load(std::memory_order_acquire))
+        {
+            unsigned int count = chunk->Count.load(std::memory_order_acquire);
+            for (unsigned int i = 0; i < count; i++)
+            {
+                const ProfileEvent& event = chunk->Events[i];
+                double start = (double)(long long)(event.Start - m_SessionStartTicks) * microsecondsPerTick;
+                stream << (first ? "\n" : ",\n") << "{\"cat\":\"function\",\"dur\":" << event.Duration * microsecondsPerTick
+                    << ",\"name\":\"";
+                WriteEscaped(stream, event.Name);
+                stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->ThreadID << ",\"ts\":" << start << "}";
+                first = false;
+            }
+        }
+    }
+
+    stream << "\n]}\n";
+    return true;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+	#define PROFILE_HAS_RDTSC 1
+#else
+	#define PROFILE_HAS_RDTSC 0
+#endif
+
+/**
+*	Set PROFILING to 0 (e.g. in the project's preprocessor definitions) to compile every PROFILE_SCOPE and
+*	PROFILE_FUNCTION out of the program.
+*/
+#ifndef PROFILING
+	#define PROFILING 1
+#endif
+
+//	One finished zone. The name is only a pointer, so it has to be a string literal (or live as long as the program).
+struct ProfileEvent
+{
+	const char* Name;
+	//	In Instrumentor::Now() ticks; only turned into time when the trace is written.
+	unsigned long long Start;
+	unsigned long long Duration;
+};
+
+/**
+*	Records how long zones of CPU code take, and writes them as a chrome://tracing (or ui.perfetto.dev) JSON file.
+*
+*	Every thread writes its zones to its own buffer, so recording needs no lock: the buffer is a list of fixed-size
+*	chunks, and a chunk's count is only ever increased by the thread that owns it. A new chunk is only allocated
+*	every ChunkSize zones. Zones are only recorded between BeginSession() and EndSession(); outside a session a zone
+*	costs one relaxed atomic load.
+*
+*	Times are read with the CPU's time stamp counter (rdtsc) where there is one, which is several times cheaper than
+*	std::chrono's clocks; the ticks are converted to time when the trace is written, by comparing the counter with
+*	steady_clock over the whole session.
+*
+*	A thread's buffer is made the first time it records a zone, and is kept until the program exits, so the
+*	events of a thread that already finished can still be written out.
+*/
+class Instrumentor
+{
+public:
+	static const unsigned int ChunkSize = 4096;
+
+	static Instrumentor& Get();
+
+	inline static unsigned long long Now()
+	{
+#if PROFILE_HAS_RDTSC
+		return __rdtsc();
+#else
+		return (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	void BeginSession();
+	//	Stops recording and writes everything recorded since BeginSession() to `filePath`. Returns false if it can't be written.
+	bool EndSession(const std::string& filePath);
+	inline bool IsRecording() const { return m_Recording.load(std::memory_order_relaxed); }
+
+	//	Only meant to be called by InstrumentationTimer.
+	void Record(const char* name, unsigned long long start, unsigned long long end);
+
+private:
+	struct Chunk
+	{
+		std::array<ProfileEvent, ChunkSize> Events;
+		std::atomic<unsigned int> Count{ 0 };
+		//	Owned by the ThreadBuffer the chunk is in.
+		std::atomic<Chunk*> Next{ nullptr };
+	};
+
+	struct ThreadBuffer
+	{
+		~ThreadBuffer();
+
+		unsigned int ThreadID = 0;
+		//	The session the events in the buffer belong to; a buffer from an older session is emptied before it's written to.
+		//	Only stored once the buffer is emptied, and EndSession() skips buffers from other sessions, so it never
+		//	reads a chain while its thread takes it apart.
+		std::atomic<unsigned int> Session{ 0 };
+		std::unique_ptr<Chunk> Head;
+		Chunk* Tail = nullptr;
+		std::vector<std::unique_ptr<Chunk>> Spare;
+	};
+
+	Instrumentor();
+
+	ThreadBuffer& GetThreadBuffer();
+	void Clear(ThreadBuffer& buffer);
+
+private:
+	std::atomic<bool> m_Recording;
+	std::atomic<unsigned int> m_Session;
+	//	The session's start in both clocks, to work out how long a tick is.
+	std::chrono::steady_clock::time_point m_SessionStart;
+	unsigned long long m_SessionStartTicks;
+
+	//	Only locked when a thread records its first zone, when a session begins, and when it's written out; so the
+	//	session can't change while it's being written.
+	std::mutex m_BuffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> m_Buffers;
+};
+
+class InstrumentationTimer
+{
+public:
+	InstrumentationTimer(const char* name)
+		: m_Name(name), m_Recording(Instrumentor::Get().IsRecording())
+	{
+		if (m_Recording)
+			m_Start = Instrumentor::Now();
+	}
+
+	~InstrumentationTimer()
+	{
+		if (m_Recording)
+			Instrumentor::Get().Record(m_Name, m_Start, Instrumentor::Now());
+	}
+
+private:
+	const char* m_Name;
+	bool m_Recording;
+	unsigned long long m_Start = 0;
+};
+
+#if PROFILING
+	#if defined(_MSC_VER)
+		#define PROFILE_FUNCTION_SIGNATURE __FUNCSIG__
+	#else
+		#define PROFILE_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+	#endif
+
+	#define PROFILE_CONCAT_INNER(a, b) a##b
+	#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+	#define PROFILE_SCOPE(name) InstrumentationTimer PROFILE_CONCAT(instrumentationTimer, __LINE__)(name)
+	#define PROFILE_FUNCTION() PROFILE_SCOPE(PROFILE_FUNCTION_SIGNATURE)
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_FUNCTION()
+#endif
@@ -0,0 +1,322 @@
+#include "JobSystem.h"
+
+#include "GLDebug.h"
+#include "Instrumentor.h"
+
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <string>
+
+
+struct Job
+{
+    std::function<void()> Function;
+    //  Counted down once Function has run; may be null.
+    JobCounter* Counter;
+};
+
+//  Which thread of the system this is, or -1 for threads outside it.
+static thread_local int t_ThreadIndex = -1;
+
+
+JobSystem::JobDeque::JobDeque()
+    : m_Top(0), m_Bottom(0)
+{
+    for (std::atomic<Job*>& job : m_Jobs)
+        job.store(nullptr, std::memory_order_relaxed);
+}
+
+bool JobSystem::JobDeque::Push(Job* job)
+{
+    long long bottom = m_Bottom.load(std::memory_order_relaxed);
+    long long top = m_Top.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity)
+        return false;
+
+    m_Jobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+    //  A thief that sees the new bottom must also see the job.
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* JobSystem::JobDeque::Pop()
+{
+    long long bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        //  Empty.
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_Jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        //  The last job; a thief may be taking it at the same time, and whoever moves top first gets it.
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* JobSystem::JobDeque::Steal()
+{
+    long long top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long bottom = m_Bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+        return nullptr;
+
+    Job* job = m_Jobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    //  Lost to the owner or another thief; the caller just looks elsewhere.
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+
+JobSystem::JobSystem(unsigned int workerCount)
+    : m_Stopping(false), m_Sleeping(0), m_LastUtilizationUpdate(std::chrono::steady_clock::now())
+{
+    for (unsigned int i = 0; i < workerCount + 1; i++)
+        m_Threads.push_back(std::make_unique<ThreadData>());
+    m_Utilization.resize(m_Threads.size(), 0.0f);
+
+    t_ThreadIndex = 0;
+    m_Workers.reserve(workerCount);
+    for (unsigned int i = 1; i <= workerCount; i++)
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    m_Stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_WakeCondition.notify_all();
+    }
+    for (std::thread& worker : m_Workers)
+        worker.join();
+
+    //  Anything still queued was never waited for; it is dropped.
+    for (int i = 0; i < (int)m_Threads.size(); i++)
+    {
+        while (Job* job = m_Threads[i]->Deque.Steal())
+            delete job;
+    }
+    for (Job* job : m_SharedJobs)
+        delete job;
+}
+
+JobSystem& JobSystem::Get()
+{
+    //  hardware_concurrency() may return 0 when it can't tell.
+    static JobSystem system(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return system;
+}
+
+void JobSystem::Run(std::function<void()> function, JobCounter* counter)
+{
+    if (counter)
+        counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+    Schedule(new Job{ std::move(function), counter });
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter)
+{
+    if (counter)
+        counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+    Job* job = new Job{ std::move(function), counter };
+    {
+        //  Execute() counts down to 0 and takes the list under the same lock, so a continuation is never lost.
+        std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+        if (dependency.m_Value.load(std::memory_order_acquire) != 0)
+        {
+            dependency.m_Continuations.push_back(job);
+            return;
+        }
+    }
+    Schedule(job);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    int index = t_ThreadIndex;
+    while (!counter.IsDone())
+    {
+        if (Job* job = FindJob(index))
+            Execute(job, index);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int minRange, const std::function<void(unsigned int, unsigned int)>& function)
+{
+    if (count == 0)
+        return;
+
+    minRange = std::max(1u, minRange);
+    //  A few ranges per thread, so a thread that finishes early can steal what's left of a slow one.
+    unsigned int rangeCount = std::min(GetThreadCount() * 4, (count + minRange - 1) / minRange);
+    if (rangeCount <= 1)
+    {
+        function(0, count);
+        return;
+    }
+
+    unsigned int rangeSize = (count + rangeCount - 1) / rangeCount;
+    JobCounter counter;
+    for (unsigned int begin = 0; begin < count; begin += rangeSize)
+    {
+        unsigned int end = std::min(count, begin + rangeSize);
+        Run([&function, begin, end]() { function(begin, end); }, &counter);
+    }
+    Wait(counter);
+}
+
+void JobSystem::Schedule(Job* job)
+{
+    int index = t_ThreadIndex;
+    if (index < 0 || !m_Threads[index]->Deque.Push(job))
+    {
+        if (index >= 0)
+        {
+            //  The deque is full; running the job now is the same as a thread popping it right away.
+            Execute(job, index);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_SharedMutex);
+        m_SharedJobs.push_back(job);
+    }
+
+    if (m_Sleeping.load(std::memory_order_relaxed) > 0)
+        m_WakeCondition.notify_one();
+}
+
+Job* JobSystem::FindJob(int index)
+{
+    if (index >= 0)
+    {
+        if (Job* job = m_Threads[index]->Deque.Pop())
+            return job;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_SharedMutex);
+        if (!m_SharedJobs.empty())
+        {
+            Job* job = m_SharedJobs.back();
+            m_SharedJobs.pop_back();
+            return job;
+        }
+    }
+
+    //  Every thread starts looking at its right neighbour, so the thieves don't all pile onto thread 0.
+    int threadCount = (int)m_Threads.size();
+    for (int i = 1; i <= threadCount; i++)
+    {
+        int victim = (std::max(index, 0) + i) % threadCount;
+        if (victim == index)
+            continue;
+        if (Job* job = m_Threads[victim]->Deque.Steal())
+            return job;
+    }
+    return nullptr;
+}
+
+void JobSystem::Execute(Job* job, int index)
+{
+    auto start = std::chrono::steady_clock::now();
+    {
+        PROFILE_SCOPE("Job");
+        job->Function();
+    }
+    if (index >= 0)
+    {
+        auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        m_Threads[index]->BusyNanoseconds.fetch_add((unsigned long long)busy.count(), std::memory_order_relaxed);
+    }
+
+    JobCounter* counter = job->Counter;
+    delete job;
+    if (!counter)
+        return;
+
+    //  Counting down and taking the continuations under the lock IsDone() takes too: a waiter can't see 0 before
+    //  the lock is released, and the counter may be gone right after, so this is the last time it's touched.
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            continuations.swap(counter->m_Continuations);
+    }
+    for (Job* continuation : continuations)
+        Schedule(continuation);
+}
+
+void JobSystem::WorkerLoop(unsigned int index)
+{
+    t_ThreadIndex = (int)index;
+
+    unsigned int idleSpins = 0;
+    while (!m_Stopping.load(std::memory_order_relaxed))
+    {
+        if (Job* job = FindJob((int)index))
+        {
+            Execute(job, (int)index);
+            idleSpins = 0;
+            continue;
+        }
+
+        //  Jobs tend to come in bursts, so a worker yields for a while before it goes to sleep.
+        if (++idleSpins < 64)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleeping.fetch_add(1);
+        m_WakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+        m_Sleeping.fetch_sub(1);
+    }
+}
+
+void JobSystem::UpdateUtilization()
+{
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_LastUtilizationUpdate).count();
+    m_LastUtilizationUpdate = now;
+    if (elapsed <= 0.0)
+        return;
+
+    for (unsigned int i = 0; i < m_Threads.size(); i++)
+    {
+        ThreadData& thread = *m_Threads[i];
+        unsigned long long busy = thread.BusyNanoseconds.load(std::memory_order_relaxed);
+        m_Utilization[i] = (float)std::min(1.0, (double)(busy - thread.LastBusyNanoseconds) / elapsed);
+        thread.LastBusyNanoseconds = busy;
+    }
+}
+
+void JobSystem::OnImGuiRender()
+{
+    for (unsigned int i = 0; i < m_Utilization.size(); i++)
+    {
+        std::string label = i == 0 ? "Main" : "Worker " + std::to_string(i);
+        ImGui::ProgressBar(m_Utilization[i], ImVec2(200.0f, 0.0f));
+        ImGui::SameLine();
+        ImGui::Text("%s", label.c_str());
+    }
+}
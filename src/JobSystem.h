@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job;
+
+/**
+*	Counts the jobs that were started with it and haven't finished yet.
+*	JobSystem::Wait() waits for it to reach 0, and JobSystem::RunAfter() starts a job when it does.
+*	It must outlive the jobs that count on it.
+*/
+class JobCounter
+{
+public:
+	JobCounter()
+		: m_Value(0) {}
+
+	//	Under the lock the last job counts down with, so once this is true no job touches the counter again
+	//	and it can be destroyed.
+	inline bool IsDone() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Value.load(std::memory_order_acquire) == 0;
+	}
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_Value;
+	//	Guards the count reaching 0 and the jobs waiting for it.
+	mutable std::mutex m_Mutex;
+	std::vector<Job*> m_Continuations;
+};
+
+/**
+*	A work-stealing job system.
+*
+*	Every thread of the system (the workers, and the thread that made the system, which is thread 0) has its own
+*	Chase-Lev deque of jobs. A thread pushes and pops jobs at the bottom of its own deque without any lock; when it
+*	runs out, it steals from the top of another thread's deque. So jobs made by a job mostly run on the same
+*	thread (while its data is still in the cache), and idle threads spread the rest out by themselves.
+*	Jobs started from threads that aren't part of the system go through one shared, locked queue.
+*
+*	Waiting (Wait(), ParallelFor()) never blocks a thread of the system: it runs other jobs until the counter is 0.
+*
+*	Jobs must not make GL calls; the context is only current on the render thread.
+*/
+class JobSystem
+{
+public:
+	//	`workerCount` threads are started; the thread that makes the system takes part too.
+	//	Only one system may exist at a time.
+	explicit JobSystem(unsigned int workerCount);
+	~JobSystem();
+
+	//	The system shared by the whole program, with one worker for every core but the render thread's.
+	//	The first call has to come from the render thread, which becomes thread 0.
+	static JobSystem& Get();
+
+	//	How many threads run jobs, counting thread 0.
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Threads.size(); }
+
+	void Run(std::function<void()> function, JobCounter* counter = nullptr);
+	//	Runs `function` once `dependency` reaches 0, or straight away if it already has.
+	void RunAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter = nullptr);
+	//	Runs other jobs until `counter` is 0.
+	void Wait(JobCounter& counter);
+
+	/**
+	*	Calls `function(begin, end)` on ranges that together cover [0, count) and returns once all of them are done.
+	*	No range is smaller than `minRange` (except the last), so tiny loops aren't split into pieces that cost
+	*	more to hand out than to run.
+	*/
+	void ParallelFor(unsigned int count, unsigned int minRange, const std::function<void(unsigned int, unsigned int)>& function);
+
+	//	Works out how busy each thread was since the last call; called once per frame.
+	void UpdateUtilization();
+	//	From 0 to 1 for each thread, thread 0 first.
+	inline const std::vector<float>& GetUtilization() const { return m_Utilization; }
+	void OnImGuiRender();
+
+private:
+	//	The deque from "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.), with a fixed size.
+	class JobDeque
+	{
+	public:
+		static const long long Capacity = 4096;
+
+		JobDeque();
+
+		//	Only the owning thread may Push() and Pop(); any thread may Steal().
+		bool Push(Job* job);
+		Job* Pop();
+		Job* Steal();
+
+	private:
+		std::atomic<long long> m_Top;
+		std::atomic<long long> m_Bottom;
+		std::array<std::atomic<Job*>, Capacity> m_Jobs;
+	};
+
+	//	Aligned so two threads' counters never share a cache line.
+	struct alignas(64) ThreadData
+	{
+		JobDeque Deque;
+		std::atomic<unsigned long long> BusyNanoseconds{ 0 };
+		unsigned long long LastBusyNanoseconds = 0;
+	};
+
+	void Schedule(Job* job);
+	//	Takes a job from the thread's own deque, the shared queue, or another thread; `index` is -1 outside the system.
+	Job* FindJob(int index);
+	void Execute(Job* job, int index);
+	void WorkerLoop(unsigned int index);
+
+private:
+	std::vector<std::unique_ptr<ThreadData>> m_Threads;
+	std::vector<std::thread> m_Workers;
+	std::atomic<bool> m_Stopping;
+
+	//	For jobs from threads outside the system.
+	std::mutex m_SharedMutex;
+	std::vector<Job*> m_SharedJobs;
+
+	//	Idle workers sleep here; they also wake up every millisecond on their own, so a missed notify only costs that.
+	std::mutex m_SleepMutex;
+	std::condition_variable m_WakeCondition;
+	std::atomic<unsigned int> m_Sleeping;
+
+	std::vector<float> m_Utilization;
+	std::chrono::steady_clock::time_point m_LastUtilizationUpdate;
+};
@@ -0,0 +1,152 @@
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+static const size_t MinMatch = 4;
+//  The format wants the last 5 bytes to be literals, and the last match to start 12 bytes before the end.
+static const size_t LastLiterals = 5;
+static const size_t MatchFindLimit = 12;
+static const size_t MaxOffset = 65535;
+static const unsigned int HashBits = 16;
+
+static uint32_t Read32(const unsigned char* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+//  Lengths of 15 and more continue in bytes of 255 until one that's smaller.
+static void WriteLength(std::vector<unsigned char>& out, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        out.push_back(255);
+    out.push_back((unsigned char)length);
+}
+
+static void WriteSequence(std::vector<unsigned char>& out, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+    size_t matchCode = matchLength - MinMatch;
+    unsigned char token = (unsigned char)((literalLength >= 15 ? 15 : literalLength) << 4);
+    if (offset)
+        token |= (unsigned char)(matchCode >= 15 ? 15 : matchCode);
+    out.push_back(token);
+
+    if (literalLength >= 15)
+        WriteLength(out, literalLength - 15);
+    out.insert(out.end(), literals, literals + literalLength);
+
+    //  The last sequence is only literals.
+    if (!offset)
+        return;
+    out.push_back((unsigned char)(offset & 0xFF));
+    out.push_back((unsigned char)(offset >> 8));
+    if (matchCode >= 15)
+        WriteLength(out, matchCode - 15);
+}
+
+std::vector<unsigned char> Lz4::Compress(const unsigned char* data, size_t size)
+{
+    std::vector<unsigned char> out;
+    out.reserve(size + size / 255 + 16);
+
+    size_t anchor = 0, position = 0;
+    if (size > MatchFindLimit)
+    {
+        //  The last position each 4 byte sequence was seen at, plus one, so 0 is empty.
+        std::vector<uint32_t> table((size_t)1 << HashBits, 0);
+        const size_t matchLimit = size - LastLiterals;
+        const size_t searchLimit = size - MatchFindLimit;
+
+        while (position < searchLimit)
+        {
+            uint32_t sequence = Read32(data + position);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - HashBits);
+            size_t candidate = table[hash];
+            table[hash] = (uint32_t)(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > MaxOffset || Read32(data + candidate - 1) != sequence)
+            {
+                position++;
+                continue;
+            }
+
+            size_t match = candidate - 1;
+            size_t length = MinMatch;
+            while (position + length < matchLimit && data[match + length] == data[position + length])
+                length++;
+
+            WriteSequence(out, data + anchor, position - anchor, position - match, length);
+            position += length;
+            anchor = position;
+        }
+    }
+    WriteSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+bool Lz4::Decompress(const unsigned char* source, size_t sourceSize, unsigned char* data, size_t size)
+{
+    const unsigned char* in = source;
+    const unsigned char* inEnd = source + sourceSize;
+    unsigned char* out = data;
+    unsigned char* outEnd = data + size;
+
+    while (in < inEnd)
+    {
+        unsigned char token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15)
+        {
+            unsigned char byte;
+            do
+            {
+                if (in >= inEnd)
+                    return false;
+                byte = *in++;
+                literalLength += byte;
+            } while (byte == 255);
+        }
+        if ((size_t)(inEnd - in) < literalLength || (size_t)(outEnd - out) < literalLength)
+            return false;
+        std::memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        if (in == inEnd)
+            break;
+
+        if (inEnd - in < 2)
+            return false;
+        size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > (size_t)(out - data))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15)
+        {
+            unsigned char byte;
+            do
+            {
+                if (in >= inEnd)
+                    return false;
+                byte = *in++;
+                matchLength += byte;
+            } while (byte == 255);
+        }
+        matchLength += MinMatch;
+        if ((size_t)(outEnd - out) < matchLength)
+            return false;
+
+        //  Byte by byte, since a match may overlap what it's copying (e.g. a run of one byte has offset 1).
+        const unsigned char* match = out - offset;
+        for (size_t i = 0; i < matchLength; i++)
+            out[i] = match[i];
+        out += matchLength;
+    }
+    return out == outEnd;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+*	The LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md), small enough to keep here
+*	instead of adding the library: a greedy compressor with one hash table, and a decompressor that checks every
+*	length against the buffers, so a corrupt pack can't write outside them.
+*	Blocks are compatible with the reference LZ4_decompress_safe(), but there is no frame format around them.
+*/
+class Lz4
+{
+public:
+	static std::vector<unsigned char> Compress(const unsigned char* data, size_t size);
+	//	`size` must be exactly the size before compressing; false if the block is corrupt.
+	static bool Decompress(const unsigned char* source, size_t sourceSize, unsigned char* data, size_t size);
+};
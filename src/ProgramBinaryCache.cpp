@@ -0,0 +1,199 @@
+#include "ProgramBinaryCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+#include "Renderer.h"
+#include "Instrumentor.h"
+#include "imgui/imgui.h"
+
+
+static thread_local ProgramBinaryCache* s_Current = nullptr;
+
+//  "GLPB": the start of every binary file, followed by the binary format and then the binary.
+static const uint32_t BinaryMagic = 0x42504C47;
+
+//  FNV-1a; the keys only have to tell sources apart, not resist anyone.
+static uint64_t Hash(const std::string& text, uint64_t hash)
+{
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static std::string GetString(GLenum name)
+{
+    const GLubyte* value;
+    GLCall(value = glGetString(name));
+    return value ? (const char*)value : "";
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+    : m_Directory(directory)
+{
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+
+    m_Driver = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) + '\n' + GetString(GL_VERSION);
+
+    int formatCount = 0;
+    if (IsSupported())
+    {
+        GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+    }
+    m_Formats.resize((size_t)formatCount);
+    if (formatCount > 0)
+    {
+        GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_Formats.data()));
+    }
+}
+
+ProgramBinaryCache::~ProgramBinaryCache()
+{
+    if (s_Current == this)
+        s_Current = nullptr;
+}
+
+bool ProgramBinaryCache::IsSupported()
+{
+    return GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary;
+}
+
+ProgramBinaryCache* ProgramBinaryCache::Get()
+{
+    return s_Current;
+}
+
+void ProgramBinaryCache::MakeCurrent(ProgramBinaryCache* cache)
+{
+    s_Current = cache;
+}
+
+std::string ProgramBinaryCache::MakeKey(const std::vector<std::string>& sources) const
+{
+    uint64_t hash = Hash(m_Driver, 14695981039346656037ull);
+    for (const std::string& source : sources)
+    {
+        //  The length too, so moving text from one stage to the next makes a different key.
+        hash = Hash(std::to_string(source.size()) + '\n', hash);
+        hash = Hash(source, hash);
+    }
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash);
+    return key;
+}
+
+std::string ProgramBinaryCache::GetFilePath(const std::string& key) const
+{
+    return m_Directory + "/" + key + ".bin";
+}
+
+unsigned int ProgramBinaryCache::Load(const std::string& key)
+{
+    PROFILE_FUNCTION();
+
+    if (m_Formats.empty())
+    {
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    std::string path = GetFilePath(key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    size_t size = (size_t)file.tellg();
+    file.seekg(0);
+    uint32_t magic = 0, format = 0;
+    file.read((char*)&magic, sizeof(magic));
+    file.read((char*)&format, sizeof(format));
+    std::vector<char> binary(size > 2 * sizeof(uint32_t) ? size - 2 * sizeof(uint32_t) : 0);
+    file.read(binary.data(), binary.size());
+    file.close();
+
+    //  glProgramBinary() with a format the driver doesn't list is an error, so those are never passed to it.
+    bool known = std::find(m_Formats.begin(), m_Formats.end(), (int)format) != m_Formats.end();
+    unsigned int program = 0;
+    int linked = GL_FALSE;
+    if (magic == BinaryMagic && known && !binary.empty())
+    {
+        GLCall(program = glCreateProgram());
+        GLCall(glProgramBinary(program, (GLenum)format, binary.data(), (GLsizei)binary.size()));
+        GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    }
+
+    if (linked == GL_FALSE)
+    {
+        if (program)
+        {
+            GLCall(glDeleteProgram(program));
+        }
+        std::remove(path.c_str());
+        m_Stats.Rejected++;
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    m_Stats.Hits++;
+    return program;
+}
+
+void ProgramBinaryCache::Store(const std::string& key, unsigned int program)
+{
+    PROFILE_FUNCTION();
+
+    if (m_Formats.empty() || program == 0)
+        return;
+
+    int linked = GL_FALSE, length = 0;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (linked == GL_FALSE || length <= 0)
+        return;
+
+    std::vector<char> binary((size_t)length);
+    GLenum format = 0;
+    GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+
+    std::ofstream file(GetFilePath(key), std::ios::binary);
+    if (!file)
+        return;
+    uint32_t magic = BinaryMagic, format32 = (uint32_t)format;
+    file.write((const char*)&magic, sizeof(magic));
+    file.write((const char*)&format32, sizeof(format32));
+    file.write(binary.data(), length);
+}
+
+void ProgramBinaryCache::RecordCreation(bool warm, double milliseconds)
+{
+    (warm ? m_Stats.WarmTime : m_Stats.ColdTime) += milliseconds;
+}
+
+void ProgramBinaryCache::OnImGuiRender() const
+{
+    ImGui::Text("Shaders: %u from binaries in %.1f ms (%.2f ms each), %u compiled in %.1f ms (%.2f ms each)",
+        m_Stats.Hits, m_Stats.WarmTime, m_Stats.Hits ? m_Stats.WarmTime / m_Stats.Hits : 0.0,
+        m_Stats.Misses, m_Stats.ColdTime, m_Stats.Misses ? m_Stats.ColdTime / m_Stats.Misses : 0.0);
+    if (m_Stats.Rejected)
+        ImGui::Text("Binaries the driver rejected: %u", m_Stats.Rejected);
+}
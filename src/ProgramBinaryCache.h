@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+*	Keeps the linked binary of every shader program on disk (glGetProgramBinary), so the next run can hand it straight
+*	back to the driver (glProgramBinary) instead of compiling and linking the GLSL again.
+*
+*	A program is keyed by a hash of its sources and of the GL_VENDOR, GL_RENDERER and GL_VERSION strings, since a binary
+*	is only good for the driver that made it. The driver may still reject a binary (e.g. after it was updated without
+*	its version string changing); the file is then deleted and the program compiled as usual.
+*
+*	Shader uses the current cache if there is one; without one (or without ARB_get_program_binary) it always compiles.
+*	The cache also keeps how long creating each program took, split by whether it came from a binary (warm) or had
+*	to be compiled (cold).
+*/
+class ProgramBinaryCache
+{
+public:
+	struct Stats
+	{
+		unsigned int Hits = 0;
+		unsigned int Misses = 0;
+		//	Binaries the driver wouldn't load; they count as misses too.
+		unsigned int Rejected = 0;
+		double WarmTime = 0.0, ColdTime = 0.0;
+	};
+
+	//	The binaries go in `directory`, which is made if it doesn't exist.
+	explicit ProgramBinaryCache(const std::string& directory = "shader_cache");
+	~ProgramBinaryCache();
+
+	ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+	ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+	//	Whether the context can hand out and take back program binaries at all.
+	static bool IsSupported();
+
+	//	The current cache, or null.
+	static ProgramBinaryCache* Get();
+	static void MakeCurrent(ProgramBinaryCache* cache);
+
+	//	The key of a program made of these sources on this driver.
+	std::string MakeKey(const std::vector<std::string>& sources) const;
+	//	A linked program made from the binary, or 0 if there is none or the driver rejected it.
+	unsigned int Load(const std::string& key);
+	//	Saves the binary of a linked program; programs that didn't link are skipped.
+	void Store(const std::string& key, unsigned int program);
+	//	Called by Shader with how long making a program took, in ms.
+	void RecordCreation(bool warm, double milliseconds);
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	void OnImGuiRender() const;
+
+private:
+	std::string GetFilePath(const std::string& key) const;
+
+private:
+	std::string m_Directory;
+	//	GL_VENDOR, GL_RENDERER and GL_VERSION, hashed into every key.
+	std::string m_Driver;
+	//	GL_PROGRAM_BINARY_FORMATS; a file in any other format is never given to the driver.
+	std::vector<int> m_Formats;
+	Stats m_Stats;
+};
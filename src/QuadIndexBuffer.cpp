@@ -0,0 +1,51 @@
+#include "QuadIndexBuffer.h"
+
+#include "Renderer.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+
+
+//  The index of vertex `i` of the index buffer; the pattern 0 1 2 2 3 0 repeats, offset by 4 for every quad.
+static constexpr unsigned int QuadIndex(unsigned int i)
+{
+    return (i / 6) * 4 + (i % 6 == 0 ? 0 : i % 6 == 1 ? 1 : i % 6 == 2 ? 2 : i % 6 == 3 ? 2 : i % 6 == 4 ? 3 : 0);
+}
+
+/**
+*   Expands to { QuadIndex(0), QuadIndex(1), ... QuadIndex(N - 1) }.
+*   Each element is its own small constant expression, unlike a loop over all of them, so it stays well
+*   under the compilers' constexpr step limits even for tens of thousands of indices.
+*/
+template<std::size_t... I>
+static constexpr std::array<unsigned int, sizeof...(I)> MakeQuadIndices(std::index_sequence<I...>)
+{
+    return { { QuadIndex((unsigned int)I)... } };
+}
+
+static constexpr std::array<unsigned int, QuadIndexBuffer::MaxIndices> s_QuadIndices =
+    MakeQuadIndices(std::make_index_sequence<QuadIndexBuffer::MaxIndices>());
+
+static_assert(s_QuadIndices[6] == 4 && s_QuadIndices[10] == 7 && s_QuadIndices[11] == 4, "quad indices are not 0 1 2 2 3 0");
+
+static std::unique_ptr<IndexBuffer> s_IndexBuffer;
+
+
+const IndexBuffer& QuadIndexBuffer::Get()
+{
+    if (!s_IndexBuffer)
+        s_IndexBuffer = std::make_unique<IndexBuffer>(s_QuadIndices.data(), MaxIndices);
+
+    return *s_IndexBuffer;
+}
+
+void QuadIndexBuffer::Shutdown()
+{
+    s_IndexBuffer.reset();
+}
+
+const unsigned int* QuadIndexBuffer::GetIndices()
+{
+    return s_QuadIndices.data();
+}
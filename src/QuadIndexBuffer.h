@@ -0,0 +1,27 @@
+#pragma once
+
+#include "IndexBuffer.h"
+
+/**
+*	Every batch of quads uses the same indices: quad i is the two triangles
+*		4i+0, 4i+1, 4i+2,	4i+2, 4i+3, 4i+0
+*	so there is no reason for each batch (or each frame) to build and upload them again.
+*
+*	This holds one immutable Index Buffer with the indices for MaxQuads quads. The indices themselves are
+*	generated at compile time; the GL buffer is made the first time Get() is called, which must be
+*	after a context has been made current. A batch with fewer quads just draws the first 6 * quadCount indices.
+*/
+class QuadIndexBuffer
+{
+public:
+	static const unsigned int MaxQuads = 10000;
+	static const unsigned int IndicesPerQuad = 6;
+	static const unsigned int MaxIndices = MaxQuads * IndicesPerQuad;
+
+	static const IndexBuffer& Get();
+	//	Deletes the GL buffer; call before the context is destroyed.
+	static void Shutdown();
+
+	//	The compile-time generated indices, in case something wants to upload them into its own buffer.
+	static const unsigned int* GetIndices();
+};
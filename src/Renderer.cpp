@@ -2,46 +2,287 @@
 
 
 #include "Renderer.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "Instrumentor.h"
+
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+
 
+Renderer::DrawStats Renderer::s_DrawStats;
 
 
-//  This just retrieves and clears all error flags
-void GLClearError()
+void Renderer::Clear() const
 {
-    //  Can be written as `while (glGetError() != GL_NO_ERROR);`
-    //  It keeps retrieving errors and clearing the flags until there are no more errors
-    while (glGetError());
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
 }
 
-bool GLLogCall(const char* functionName, const char* fileName, int line)
+void Renderer::Draw(const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader) const
 {
-    //  The below checks for an error and since it returns a GLenum (same as an unsigned int enum)
-    //  this assignes the value to the variable 'error'.
-    //  It gets the error as long as the 'error' value gotten is not 0
-    while (GLenum error = glGetError())
+    PROFILE_FUNCTION();
+    GPU_PROFILE_SCOPE("Renderer::Draw");
+
+    shader.Bind();
+    //  Bind just the Vertex Array Object
+    vao.Bind();
+    //  bind index buffer
+    ibo.Bind();
+
+    GLCall(glDrawElements(GL_TRIANGLES, ibo.GetCount(), GL_UNSIGNED_INT, nullptr)); //  <- used with an index buffer.
+    s_DrawStats.DrawCalls++;
+    s_DrawStats.Indices += ibo.GetCount();
+
+}
+
+void Renderer::Draw(const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, unsigned int indexCount, int baseVertex) const
+{
+    PROFILE_FUNCTION();
+    GPU_PROFILE_SCOPE("Renderer::Draw");
+
+    ASSERT(indexCount <= ibo.GetCount());
+
+    shader.Bind();
+    vao.Bind();
+    ibo.Bind();
+
+    if (baseVertex == 0)
+    {
+        GLCall(glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr));
+    }
+    else
     {
-        std::cout << "[OpenGL Error] (" << error << "): " << functionName << " " << fileName << ":" << line << "\n";
-        return false;
+        GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, baseVertex));
     }
-    return true;
+    s_DrawStats.DrawCalls++;
+    s_DrawStats.Indices += indexCount;
 }
 
-void Renderer::Clear() const
+void Renderer::DrawInstanced(const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, unsigned int instanceCount) const
 {
-    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    if (instanceCount == 0)
+        return;
+
+    GPU_PROFILE_SCOPE("Renderer::DrawInstanced");
+
+    shader.Bind();
+    vao.Bind();
+    ibo.Bind();
+
+    GLCall(glDrawElementsInstanced(GL_TRIANGLES, ibo.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount));
+    s_DrawStats.DrawCalls++;
+    s_DrawStats.Indices += (unsigned long long)ibo.GetCount() * instanceCount;
 }
 
-void Renderer::Draw(const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader) const
+unsigned int Renderer::DrawIndirect(const VertexArray& vao, const IndexBuffer& ibo, Shader& shader, const IndirectDrawBuffer& draws) const
 {
+    if (draws.GetDrawCount() == 0)
+        return 0;
+
+    GPU_PROFILE_SCOPE("Renderer::DrawIndirect");
+
     shader.Bind();
-    //  Bind just the Vertex Array Object
     vao.Bind();
-    //  bind index buffer
     ibo.Bind();
 
-    GLCall(glDrawElements(GL_TRIANGLES, ibo.GetCount(), GL_UNSIGNED_INT, nullptr)); //  <- used with an index buffer.
+    if (IndirectDrawBuffer::IsSupported())
+    {
+        draws.Bind(0);
+        //  `indirect` is an offset into the bound GL_DRAW_INDIRECT_BUFFER, and a stride of 0 means tightly packed.
+        GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)draws.GetDrawCount(), 0));
+        s_DrawStats.DrawCalls++;
+        for (const DrawElementsIndirectCommand& command : draws.GetCommands())
+            s_DrawStats.Indices += command.Count;
+        return 1;
+    }
+
+    const std::vector<DrawElementsIndirectCommand>& commands = draws.GetCommands();
+    const std::vector<IndirectDrawData>& drawData = draws.GetDrawData();
+    for (size_t i = 0; i < commands.size(); i++)
+    {
+        const DrawElementsIndirectCommand& command = commands[i];
+        shader.SetUniformMat4("u_MVP", drawData[i].MVP);
+        shader.SetUniform1i("u_TexIndex", drawData[i].TexIndex);
+        //  The first index is in indices, but glDrawElements wants a byte offset into the index buffer.
+        void* offset = (void*)(size_t)(command.FirstIndex * sizeof(unsigned int));
+        GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, command.Count, GL_UNSIGNED_INT, offset, command.BaseVertex));
+        s_DrawStats.DrawCalls++;
+        s_DrawStats.Indices += command.Count;
+    }
+    return (unsigned int)commands.size();
+}
+
+uint64_t Renderer::MakeSortKey(unsigned int layer, unsigned int shader, unsigned int textureSet, unsigned int vao, float depth)
+{
+    //  GL names are small numbers handed out from 1 upward, so keeping just the low bits of each rarely mixes two objects up.
+    //  And if it does, the draws are still correct; they are only not grouped as well.
+    uint64_t quantizedDepth = (uint64_t)(std::min(std::max(depth, 0.0f), 1.0f) * 65535.0f);
 
+    return ((uint64_t)(layer & 0xff) << 56)
+        | ((uint64_t)(shader & 0xfff) << 44)
+        | ((uint64_t)(textureSet & 0xffff) << 28)
+        | ((uint64_t)(vao & 0xfff) << 16)
+        | quantizedDepth;
 }
 
+void Renderer::SetMode(RenderMode mode)
+{
+    //  Switching in the middle of a frame would draw the commands recorded so far out of order with the immediate ones.
+    ASSERT(m_Commands.empty());
+    m_Mode = mode;
+}
 
+void Renderer::Submit(const VertexArray& vao, const IndexBuffer& ib, Shader& shader, const glm::mat4& mvp,
+    const unsigned int* textures, unsigned int textureCount, unsigned int layer, float depth, unsigned int indexCount, int baseVertex)
+{
+    ASSERT(textureCount <= DrawCommand::MaxTextures);
+
+    DrawCommand command;
+    command.VAO = &vao;
+    command.IBO = &ib;
+    command.Program = &shader;
+    command.Textures.fill(0);
+    //  The texture set is identified by folding the texture names into one number.
+    unsigned int textureSet = 0;
+    for (unsigned int i = 0; i < textureCount; i++)
+    {
+        command.Textures[i] = textures[i];
+        textureSet = textureSet * 31 + textures[i];
+    }
+    command.TextureCount = textureCount;
+    command.IndexCount = indexCount ? indexCount : ib.GetCount();
+    command.BaseVertex = baseVertex;
+    command.MVP = mvp;
+    command.Key = MakeSortKey(layer, shader.GetRendererID(), textureSet, vao.GetRendererID(), depth);
+
+    m_QueueStats.Commands++;
+
+    if (m_Mode == RenderMode::Immediate)
+    {
+        //  Nothing is remembered between immediate draws, as Draw() wouldn't either.
+        ResetLastCommand();
+        ExecuteCommand(command);
+        return;
+    }
+
+    m_Commands.push_back(command);
+}
+
+void Renderer::Execute()
+{
+    if (m_Commands.empty())
+        return;
+
+    GPU_PROFILE_SCOPE("Renderer::Execute");
+
+    SortCommands();
+
+    ResetLastCommand();
+    for (uint32_t index : m_SortedIndices)
+        ExecuteCommand(m_Commands[index]);
+
+    m_Commands.clear();
+}
+
+void Renderer::SortCommands()
+{
+    const uint32_t count = (uint32_t)m_Commands.size();
+    m_SortedIndices.resize(count);
+    m_SortScratch.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+        m_SortedIndices[i] = i;
+
+    //  8 passes of one byte each, from the lowest byte up. Each pass is stable, which is what makes the whole sort correct.
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        uint32_t offsets[257] = {};
+        for (uint32_t i = 0; i < count; i++)
+            offsets[((m_Commands[i].Key >> shift) & 0xff) + 1]++;
+
+        //  If every key has the same byte here (e.g. all on one layer), the pass wouldn't move anything.
+        bool allSame = false;
+        for (unsigned int digit = 1; digit <= 256; digit++)
+        {
+            if (offsets[digit] == count)
+            {
+                allSame = true;
+                break;
+            }
+        }
+        if (allSame)
+            continue;
+
+        for (unsigned int digit = 1; digit <= 256; digit++)
+            offsets[digit] += offsets[digit - 1];
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t index = m_SortedIndices[i];
+            m_SortScratch[offsets[(m_Commands[index].Key >> shift) & 0xff]++] = index;
+        }
+        m_SortedIndices.swap(m_SortScratch);
+    }
+}
+
+void Renderer::ResetLastCommand()
+{
+    m_LastShader = nullptr;
+    m_LastVAO = nullptr;
+    m_LastIBO = nullptr;
+    m_LastTextures.fill(0);
+}
+
+void Renderer::ExecuteCommand(const DrawCommand& command)
+{
+    bool shaderChanged = command.Program != m_LastShader;
+    if (shaderChanged)
+    {
+        command.Program->Bind();
+        m_LastShader = command.Program;
+        m_QueueStats.ShaderChanges++;
+    }
+
+    //  The uniform belongs to the program, so it only has to be uploaded again if it differs from the last command's.
+    if (shaderChanged || std::memcmp(&command.MVP, &m_LastMVP, sizeof(glm::mat4)) != 0)
+    {
+        command.Program->SetUniformMat4("u_MVP", command.MVP);
+        m_LastMVP = command.MVP;
+        m_QueueStats.UniformUploads++;
+    }
+
+    for (unsigned int i = 0; i < command.TextureCount; i++)
+    {
+        if (command.Textures[i] != m_LastTextures[i])
+        {
+            GLStateCache::Get().BindTextureUnit(i, command.Textures[i]);
+            m_LastTextures[i] = command.Textures[i];
+            m_QueueStats.TextureChanges++;
+        }
+    }
+
+    if (command.VAO != m_LastVAO)
+    {
+        command.VAO->Bind();
+        m_LastVAO = command.VAO;
+        //  The element buffer is part of the vertex array's state, so it has to be bound again with a new one.
+        m_LastIBO = nullptr;
+        m_QueueStats.VertexArrayChanges++;
+    }
+    if (command.IBO != m_LastIBO)
+    {
+        command.IBO->Bind();
+        m_LastIBO = command.IBO;
+    }
+
+    if (command.BaseVertex == 0)
+    {
+        GLCall(glDrawElements(GL_TRIANGLES, command.IndexCount, GL_UNSIGNED_INT, nullptr));
+    }
+    else
+    {
+        GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, command.IndexCount, GL_UNSIGNED_INT, nullptr, command.BaseVertex));
+    }
+    s_DrawStats.DrawCalls++;
+    s_DrawStats.Indices += command.IndexCount;
+}
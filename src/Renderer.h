@@ -3,21 +3,46 @@
 
 #include <GL/glew.h>
 
+#include <array>
+#include <vector>
+#include <cstdint>
+
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "IndirectDrawBuffer.h"
+#include "GLDebug.h"
+#include "glm/glm.hpp"
 
-#define ASSERT(x) if (!(x)) __debugbreak();
-
-#define GLCall(x) GLClearError();\
-    x;\
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__))
 
+//  Whether Renderer::Submit() draws straight away, or records the draw so Renderer::Execute() can sort it first.
+enum class RenderMode
+{
+    Immediate = 0, Sorted = 1
+};
 
-//  This just retrieves and clears all error flags
-void GLClearError();
+/**
+*   Everything needed to replay one draw later on.
+*
+*   Uniforms are captured when the command is submitted, because by the time it is executed the shader
+*   may have been used with other values. Only `u_MVP` is captured; that is the only uniform the tests
+*   change between draws of the same shader.
+*/
+struct DrawCommand
+{
+    //  Textures are bound to units 0, 1, 2... in this order.
+    static const unsigned int MaxTextures = 4;
 
-bool GLLogCall(const char* functionName, const char* fileName, int line);
+    uint64_t Key;
+    const VertexArray* VAO;
+    const IndexBuffer* IBO;
+    Shader* Program;
+    std::array<unsigned int, MaxTextures> Textures;
+    unsigned int TextureCount;
+    unsigned int IndexCount;
+    int BaseVertex;
+    glm::mat4 MVP;
+};
 
 /**
 *   Some people choose to make this a Singleton, and some don''t because they would
@@ -28,6 +53,16 @@ bool GLLogCall(const char* functionName, const char* fileName, int line);
 class Renderer
 {
 public:
+    //  Counted over every Renderer, since the tests make a new one wherever they draw.
+    struct DrawStats
+    {
+        unsigned int DrawCalls = 0;
+        unsigned long long Indices = 0;
+    };
+
+    inline static const DrawStats& GetDrawStats() { return s_DrawStats; }
+    inline static void ResetDrawStats() { s_DrawStats = DrawStats(); }
+
     /**
     *   Needs Vertex Array(which has Vertex Buffer bound to it), Index Buffer, Valid Shader.
     *   Now, the index buffer has an Index Count -- it can be drawn partially, or drawn considering the whole index buffer.
@@ -35,5 +70,85 @@ public:
     *   to consider), to draw with a partial Index Buffer, an Index Buffer with a partial set of indices will be passed.
     */
     void Draw(const VertexArray& vao, const IndexBuffer& ib, const Shader& shader) const;
+    //  Draws only the first `indexCount` indices of the Index Buffer; used by batches that fill it partially.
+    //  `baseVertex` is added to every index, for when the vertices don't start at the beginning of the Vertex Buffer.
+    void Draw(const VertexArray& vao, const IndexBuffer& ib, const Shader& shader, unsigned int indexCount, int baseVertex = 0) const;
     void Clear() const;
+    //  Draws the whole Index Buffer `instanceCount` times in one call; per-instance attributes come from buffers
+    //  added to the Vertex Array with a layout divisor (VertexBufferLayout::SetDivisor).
+    void DrawInstanced(const VertexArray& vao, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const;
+    /**
+    *   Draws everything in the IndirectDrawBuffer with one glMultiDrawElementsIndirect; the shader reads the per-draw
+    *   data from storage buffer binding 0 with gl_DrawID.
+    *   Without support for that, it draws them one by one and sets `u_MVP` and `u_TexIndex` for each instead.
+    *   Returns the number of draw calls made.
+    */
+    unsigned int DrawIndirect(const VertexArray& vao, const IndexBuffer& ib, Shader& shader, const IndirectDrawBuffer& draws) const;
+
+    /**
+    *   The command queue.
+    *
+    *   In RenderMode::Immediate, Submit() draws right away, just like Draw().
+    *   In RenderMode::Sorted, Submit() only records a DrawCommand, and Execute() sorts all the commands of the frame
+    *   by their key and draws them, so draws that share a shader, textures and vertex array end up next to each other
+    *   and the state only changes when it has to.
+    *
+    *   The key, from the most significant bits down:
+    *       layer (8) | shader (12) | texture set (16) | vertex array (12) | depth (16)
+    *   so the layer always wins; anything that has to be drawn after something else (e.g. transparent things over
+    *   opaque ones) goes on a higher layer. The sort is stable, so commands with the same key keep the order they
+    *   were submitted in. `depth` is from 0 to 1.
+    *
+    *   The mode can be changed every frame, but not between Submit() and Execute().
+    */
+    struct QueueStats
+    {
+        unsigned int Commands = 0;
+        unsigned int ShaderChanges = 0;
+        unsigned int TextureChanges = 0;
+        unsigned int VertexArrayChanges = 0;
+        unsigned int UniformUploads = 0;
+    };
+
+    static uint64_t MakeSortKey(unsigned int layer, unsigned int shader, unsigned int textureSet, unsigned int vao, float depth);
+
+    void SetMode(RenderMode mode);
+    inline RenderMode GetMode() const { return m_Mode; }
+
+    //  `indexCount` of 0 draws the whole index buffer.
+    void Submit(const VertexArray& vao, const IndexBuffer& ib, Shader& shader, const glm::mat4& mvp,
+        const unsigned int* textures = nullptr, unsigned int textureCount = 0,
+        unsigned int layer = 0, float depth = 0.0f, unsigned int indexCount = 0, int baseVertex = 0);
+    //  Sorts and draws everything that was submitted since the last Execute(). Nothing to do in immediate mode.
+    void Execute();
+
+    inline const QueueStats& GetQueueStats() const { return m_QueueStats; }
+    inline void ResetQueueStats() { m_QueueStats = QueueStats(); }
+
+private:
+    //  Binds only what differs from the command that was drawn before it, then draws.
+    void ExecuteCommand(const DrawCommand& command);
+    //  Least significant digit radix sort of the command keys; fills m_SortedIndices.
+    void SortCommands();
+    //  Forgets the previous command, so the first command of a frame binds everything.
+    void ResetLastCommand();
+
+private:
+    static DrawStats s_DrawStats;
+
+    RenderMode m_Mode = RenderMode::Immediate;
+
+    //  The commands of the current frame. They are cleared, not freed, in Execute() so the memory is reused every frame.
+    std::vector<DrawCommand> m_Commands;
+    std::vector<uint32_t> m_SortedIndices;
+    std::vector<uint32_t> m_SortScratch;
+
+    //  What ExecuteCommand() last bound.
+    const Shader* m_LastShader = nullptr;
+    const VertexArray* m_LastVAO = nullptr;
+    const IndexBuffer* m_LastIBO = nullptr;
+    std::array<unsigned int, DrawCommand::MaxTextures> m_LastTextures{};
+    glm::mat4 m_LastMVP;
+
+    QueueStats m_QueueStats;
 };
\ No newline at end of file
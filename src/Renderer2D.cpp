@@ -0,0 +1,350 @@
+#include "Renderer2D.h"
+
+#include "VertexBufferLayout.h"
+#include "GLStateCache.h"
+#include "AssetManager.h"
+#include "BindlessTextures.h"
+#include "GpuProfiler.h"
+#include "JobSystem.h"
+#include "Instrumentor.h"
+
+#include <algorithm>
+
+
+//  Writes the 4 corners of a quad, counter-clockwise from the bottom left.
+static inline void WriteQuadVertices(QuadVertex* v, const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, float texIndex,
+    const glm::vec2& uvMin = glm::vec2(0.0f), const glm::vec2& uvMax = glm::vec2(1.0f))
+{
+    v[0] = { { position.x,          position.y,          position.z }, color, { uvMin.x, uvMin.y }, texIndex };
+    v[1] = { { position.x + size.x, position.y,          position.z }, color, { uvMax.x, uvMin.y }, texIndex };
+    v[2] = { { position.x + size.x, position.y + size.y, position.z }, color, { uvMax.x, uvMax.y }, texIndex };
+    v[3] = { { position.x,          position.y + size.y, position.z }, color, { uvMin.x, uvMax.y }, texIndex };
+}
+
+
+Renderer2D::Renderer2D(const std::string& shaderPath)
+    : m_WhiteTexture(0), m_Vertices(nullptr), m_QuadCount(0), m_TextureSlots{}, m_TextureSlotCount(1), m_TextureSlotLimit(MaxTextureSlots),
+    m_TextureMode(TextureMode::Slots), m_HandleBuffer(0)
+{
+    m_VAO = std::make_unique<VertexArray>();
+    /**
+    *   Each region holds two full batches, and the ring has 3 regions so a frame can write into one
+    *   while the GPU is still drawing the previous two.
+    */
+    m_VertexBuffer = std::make_unique<StreamingVertexBuffer>((unsigned int)sizeof(QuadVertex), 2 * MaxVertices, 3);
+
+    VertexBufferLayout layout;
+    layout.Push<float>(3u); //  x y z
+    layout.Push<float>(4u); //  r g b a
+    layout.Push<float>(2u); //  u v
+    layout.Push<float>(1u); //  tex index
+    m_VAO->AddBuffer(*m_VertexBuffer, layout);
+
+
+    //  The white texture lets untextured quads go through the same shader; color * white = color.
+    unsigned int white = 0xffffffff;
+    GLCall(glGenTextures(1, &m_WhiteTexture));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, m_WhiteTexture);
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+    m_TextureSlots[0] = m_WhiteTexture;
+
+    //  Not every GPU has 16 texture units for the fragment shader (mobile may only have 8), and a sampler array
+    //  bigger than that doesn't link, so the shader's array is sized to the limit too.
+    m_TextureSlotLimit = std::min(MaxTextureSlots, (unsigned int)Shader::GetMaxTextureUnits());
+
+    //  Compiled in the background; the first frames of a test may draw its quads with the fallback program.
+    m_Shader = AssetManager::Get().GetShaderVariant(shaderPath, { "MAX_TEXTURES=" + std::to_string(m_TextureSlotLimit) }, ShaderLoad::Async);
+
+    int samplers[MaxTextureSlots];
+    for (unsigned int i = 0; i < m_TextureSlotLimit; i++)
+        samplers[i] = (int)i;
+    m_Shader->Bind();
+    m_Shader->SetUniform1iv("u_Textures", (int)m_TextureSlotLimit, samplers);
+
+    if (BindlessTextures::IsSupported())
+    {
+        m_BindlessShader = AssetManager::Get().GetShader("res/shaders/Renderer2D/QuadBindless.shader", ShaderLoad::Async);
+        GLCall(glGenBuffers(1, &m_HandleBuffer));
+        m_TextureMode = TextureMode::Bindless;
+    }
+    ResetTextureSlots();
+}
+
+Renderer2D::~Renderer2D()
+{
+    if (m_HandleBuffer)
+    {
+        GLStateCache::Get().OnDeleteBuffer(m_HandleBuffer);
+        GLCall(glDeleteBuffers(1, &m_HandleBuffer));
+    }
+
+    BindlessTextures::Release(m_WhiteTexture);
+    GLStateCache::Get().OnDeleteTexture(m_WhiteTexture);
+    GLCall(glDeleteTextures(1, &m_WhiteTexture));
+}
+
+void Renderer2D::BeginBatch()
+{
+    ASSERT(m_Vertices == nullptr);
+
+    m_QuadCount = 0;
+    ResetTextureSlots();
+    m_Vertices = (QuadVertex*)m_VertexBuffer->Map(MaxVertices);
+}
+
+void Renderer2D::EndBatch()
+{
+    DrawBatch();
+
+    m_Vertices = nullptr;
+    //  Everything for this batch has been drawn, so the region can be handed back to the GPU.
+    m_VertexBuffer->Fence();
+}
+
+void Renderer2D::Flush()
+{
+    DrawBatch();
+    m_Vertices = (QuadVertex*)m_VertexBuffer->Map(MaxVertices);
+}
+
+void Renderer2D::DrawBatch()
+{
+    if (m_QuadCount == 0)
+        return;
+
+    GPU_PROFILE_SCOPE("Renderer2D::DrawBatch");
+    //  Only the part of the region that was written this batch is committed.
+    unsigned int baseVertex = m_VertexBuffer->Unmap(m_QuadCount * 4);
+
+    Shader* shader = m_Shader.get();
+    if (m_TextureMode == TextureMode::Bindless)
+    {
+        m_Handles.clear();
+        //  A texture still streaming in can't have a handle yet, so it's drawn white until its pixels are there.
+        for (unsigned int texture : m_BindlessTextures)
+            m_Handles.push_back(BindlessTextures::GetHandle(BindlessTextures::IsStreaming(texture) ? m_WhiteTexture : texture));
+
+        //  Orphaned every batch, since the previous batch's draw may still be reading it.
+        GLStateCache::Get().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_HandleBuffer);
+        GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, m_Handles.size() * sizeof(GLuint64), m_Handles.data(), GL_STREAM_DRAW));
+        GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_HandleBuffer));
+        shader = m_BindlessShader.get();
+    }
+    else
+    {
+        //  Slots that hold the same texture as in the last batch are skipped by the cache.
+        for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+            GLStateCache::Get().BindTextureUnit(i, m_TextureSlots[i]);
+    }
+
+    //  The vertices are in world space and the camera is in the Frame block, so there's no uniform to set.
+    shader->Bind();
+
+    Renderer renderer;
+    renderer.Draw(*m_VAO, QuadIndexBuffer::Get(), *shader, m_QuadCount * QuadIndexBuffer::IndicesPerQuad, (int)baseVertex);
+
+    m_Stats.DrawCalls++;
+
+    m_QuadCount = 0;
+    ResetTextureSlots();
+}
+
+bool Renderer2D::SetTextureMode(TextureMode mode)
+{
+    ASSERT(m_Vertices == nullptr);
+
+    if (mode == TextureMode::Bindless && !m_BindlessShader)
+        return false;
+
+    m_TextureMode = mode;
+    ResetTextureSlots();
+    return true;
+}
+
+void Renderer2D::ResetTextureSlots()
+{
+    m_TextureSlotCount = 1;
+    if (m_TextureMode == TextureMode::Bindless)
+    {
+        m_BindlessTextures.assign(1, m_WhiteTexture);
+        m_BindlessSlots.clear();
+        m_BindlessSlots[m_WhiteTexture] = 0;
+    }
+}
+
+int Renderer2D::FindTextureSlot(unsigned int textureID) const
+{
+    if (m_TextureMode == TextureMode::Bindless)
+    {
+        auto it = m_BindlessSlots.find(textureID);
+        return it != m_BindlessSlots.end() ? (int)it->second : -1;
+    }
+
+    for (unsigned int i = 1; i < m_TextureSlotCount; i++)
+    {
+        if (m_TextureSlots[i] == textureID)
+            return (int)i;
+    }
+    return -1;
+}
+
+int Renderer2D::AddTextureSlot(unsigned int textureID)
+{
+    if (m_TextureMode == TextureMode::Bindless)
+    {
+        unsigned int slot = (unsigned int)m_BindlessTextures.size();
+        m_BindlessTextures.push_back(textureID);
+        m_BindlessSlots[textureID] = slot;
+        return (int)slot;
+    }
+
+    if (m_TextureSlotCount >= m_TextureSlotLimit)
+        return -1;
+
+    m_TextureSlots[m_TextureSlotCount] = textureID;
+    return (int)m_TextureSlotCount++;
+}
+
+float Renderer2D::GetTextureSlot(unsigned int textureID)
+{
+    int slot = FindTextureSlot(textureID);
+    if (slot >= 0)
+        return (float)slot;
+
+    slot = AddTextureSlot(textureID);
+    if (slot < 0)
+    {
+        Flush();
+        slot = AddTextureSlot(textureID);
+    }
+    return (float)slot;
+}
+
+void Renderer2D::WriteQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, float texIndex,
+    const glm::vec2& uvMin, const glm::vec2& uvMax)
+{
+    ASSERT(m_Vertices);
+    if (m_QuadCount >= MaxQuads)
+        Flush();
+
+    WriteQuadVertices(&m_Vertices[m_QuadCount * 4], position, size, color, texIndex, uvMin, uvMax);
+
+    m_QuadCount++;
+    m_Stats.QuadCount++;
+}
+
+void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+{
+    DrawQuad(glm::vec3(position, 0.0f), size, color);
+}
+
+void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
+{
+    WriteQuad(position, size, color, 0.0f);
+}
+
+void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint)
+{
+    DrawQuad(glm::vec3(position, 0.0f), size, texture.GetRendererID(), tint);
+}
+
+void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint)
+{
+    DrawQuad(position, size, texture.GetRendererID(), tint);
+}
+
+void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, unsigned int textureID, const glm::vec4& tint)
+{
+    //  The slot has to be found before the quad is written; if it causes a flush the quad goes into the next batch.
+    if (m_QuadCount >= MaxQuads)
+        Flush();
+
+    float texIndex = GetTextureSlot(textureID);
+    WriteQuad(position, size, tint, texIndex);
+}
+
+void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const SubTexture& subTexture, const glm::vec4& tint)
+{
+    DrawQuad(glm::vec3(position, 0.0f), size, subTexture, tint);
+}
+
+void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const SubTexture& subTexture, const glm::vec4& tint)
+{
+    if (m_QuadCount >= MaxQuads)
+        Flush();
+
+    float texIndex = GetTextureSlot(subTexture.GetTextureID());
+    WriteQuad(position, size, tint, texIndex, subTexture.GetMin(), subTexture.GetMax());
+}
+
+void Renderer2D::DrawQuads(const Sprite* sprites, unsigned int count)
+{
+    PROFILE_FUNCTION();
+    ASSERT(m_Vertices);
+
+    //  Starting from an empty batch lets every worker work out where its quads go from the sprite index alone.
+    if (m_QuadCount > 0)
+        Flush();
+
+    m_SpriteSlots.resize(count);
+
+    unsigned int begin = 0;
+    while (begin < count)
+    {
+        //  How many sprites fit in this batch, and the slot of each one's texture.
+        unsigned int end = begin;
+        unsigned int lastTexture = 0;
+        float lastSlot = 0.0f;
+        while (end < count && end - begin < MaxQuads)
+        {
+            unsigned int textureID = sprites[end].TextureID;
+            float slot = 0.0f;
+            if (textureID != 0)
+            {
+                //  Sprites tend to come in runs of the same texture, so the last one is checked before the slots.
+                if (textureID == lastTexture)
+                    slot = lastSlot;
+                else
+                {
+                    int found = FindTextureSlot(textureID);
+                    if (found < 0)
+                    {
+                        found = AddTextureSlot(textureID);
+                        if (found < 0)
+                            break;
+                    }
+                    slot = (float)found;
+                    lastTexture = textureID;
+                    lastSlot = slot;
+                }
+            }
+            m_SpriteSlots[end] = slot;
+            end++;
+        }
+
+        QuadVertex* vertices = m_Vertices;
+        const float* slots = m_SpriteSlots.data();
+        //  Each range is a disjoint slice of the mapping, so the workers never write to the same memory.
+        JobSystem::Get().ParallelFor(end - begin, 4096, [vertices, sprites, slots, begin](unsigned int first, unsigned int last)
+        {
+            for (unsigned int i = first; i < last; i++)
+            {
+                const Sprite& sprite = sprites[begin + i];
+                WriteQuadVertices(&vertices[i * 4], sprite.Position, sprite.Size, sprite.Color, slots[begin + i]);
+            }
+        });
+
+        m_QuadCount = end - begin;
+        m_Stats.QuadCount += m_QuadCount;
+        begin = end;
+
+        //  The last batch stays open, so quads drawn after this can still go in with it.
+        if (begin < count)
+            Flush();
+    }
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <memory>
+#include <array>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "Renderer.h"
+#include "StreamingVertexBuffer.h"
+#include "Texture.h"
+#include "SubTexture.h"
+#include "QuadIndexBuffer.h"
+#include "glm/glm.hpp"
+
+/**
+*	The layout every quad vertex is written in.
+*	It must match the layout pushed in Renderer2D's constructor and the attributes in the batch shader.
+*/
+struct QuadVertex
+{
+	glm::vec3 Position;
+	glm::vec4 Color;
+	glm::vec2 TexCoords;
+	float TexIndex;
+};
+
+//	One quad for Renderer2D::DrawQuads(); a TextureID of 0 means it's only colored.
+struct Sprite
+{
+	glm::vec3 Position;
+	glm::vec2 Size;
+	glm::vec4 Color;
+	unsigned int TextureID;
+};
+
+/**
+*	A retained batch renderer for quads.
+*
+*	Rather than every test building its own vertex array by hand, the Renderer2D owns one
+*	StreamingVertexBuffer and one Vertex Array, and draws with the shared QuadIndexBuffer.
+*	DrawQuad() writes four vertices straight into the mapped vertex buffer; nothing is drawn until
+*	the batch is flushed. A flush happens:
+*		1.	at EndBatch(),
+*		2.	when the vertex array is full (MaxQuads), or
+*		3.	when a quad needs a texture but all the texture slots of the batch are taken.
+*	So any number of quads can be drawn per frame; it just becomes more than one draw call.
+*
+*	Slot 0 is always a 1x1 white texture so that colored quads and textured quads share the same shader
+*	and can be drawn in the same batch.
+*
+*	Where the GPU has ARB_bindless_texture, the renderer uses TextureMode::Bindless instead: the tex index of a
+*	vertex is an index into a shader storage buffer of texture handles that is uploaded with each batch, and
+*	nothing is bound to the texture units, so running out of texture slots (case 3) never happens.
+*/
+class Renderer2D
+{
+public:
+	enum class TextureMode
+	{
+		//	Up to MaxTextureSlots textures bound to units per batch, indexed through a sampler array.
+		Slots,
+		//	Any number of textures per batch, through resident ARB_bindless_texture handles.
+		Bindless
+	};
+
+	struct Stats
+	{
+		unsigned int DrawCalls = 0;
+		unsigned int QuadCount = 0;
+
+		inline unsigned int GetVertexCount() const { return QuadCount * 4; }
+		inline unsigned int GetIndexCount() const { return QuadCount * 6; }
+	};
+
+	static const unsigned int MaxQuads = QuadIndexBuffer::MaxQuads;
+	static const unsigned int MaxVertices = MaxQuads * 4;
+	static const unsigned int MaxIndices = MaxQuads * 6;
+	//	The most texture slots a batch uses; fewer if the GPU has fewer texture units.
+	static const unsigned int MaxTextureSlots = 16;
+
+	//	The shader is compiled with MAX_TEXTURES=N, the slots it's used with, to size its `u_Textures` sampler array.
+	Renderer2D(const std::string& shaderPath = "res/shaders/Renderer2D/Quad.shader");
+	~Renderer2D();
+
+	//	Starts a new batch; every quad until EndBatch() is seen through the camera of FrameUniforms.
+	void BeginBatch();
+	//	Flushes whatever is left in the batch.
+	void EndBatch();
+	//	Sends the quads written so far to the GPU in one draw call, and starts an empty batch.
+	void Flush();
+
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f));
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f));
+	//	For textures that are not wrapped by the Texture class, e.g. the ones made by the batch rendering tests.
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, unsigned int textureID, const glm::vec4& tint = glm::vec4(1.0f));
+	//	Draws just the rectangle of the texture the SubTexture covers, e.g. one image of a TextureAtlas.
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const SubTexture& subTexture, const glm::vec4& tint = glm::vec4(1.0f));
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, const SubTexture& subTexture, const glm::vec4& tint = glm::vec4(1.0f));
+
+	/**
+	*	Draws many sprites at once, writing their vertices on all the threads of the JobSystem.
+	*	The sprites are first cut into batches (by MaxQuads and by texture slots) on this thread, which is cheap,
+	*	then each worker writes the quads of its own range of the batch straight into the mapped vertex buffer.
+	*	Only this thread makes GL calls. The result is the same as calling DrawQuad() for each sprite in order.
+	*/
+	void DrawQuads(const Sprite* sprites, unsigned int count);
+	inline void DrawQuads(const std::vector<Sprite>& sprites) { DrawQuads(sprites.data(), (unsigned int)sprites.size()); }
+
+	//	Bindless is only possible if BindlessTextures::IsSupported(); returns false otherwise.
+	//	Must be called outside BeginBatch() / EndBatch().
+	bool SetTextureMode(TextureMode mode);
+	inline TextureMode GetTextureMode() const { return m_TextureMode; }
+	inline const char* GetTextureModeName() const { return m_TextureMode == TextureMode::Bindless ? "bindless" : "texture slots"; }
+
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); m_VertexBuffer->ResetStats(); }
+	inline const StreamingVertexBuffer& GetVertexBuffer() const { return *m_VertexBuffer; }
+
+private:
+	//	Draws what has been written so far and empties the batch, without mapping room for a new one.
+	void DrawBatch();
+	//	Returns the slot the texture is bound to in this batch, flushing first if there is no free slot.
+	float GetTextureSlot(unsigned int textureID);
+	//	The slot the texture already has in this batch, or -1.
+	int FindTextureSlot(unsigned int textureID) const;
+	//	Gives the texture the next slot, or returns -1 if they're all taken (which never happens in bindless mode).
+	int AddTextureSlot(unsigned int textureID);
+	//	Leaves only the white texture in slot 0.
+	void ResetTextureSlots();
+	void WriteQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, float texIndex,
+		const glm::vec2& uvMin = glm::vec2(0.0f), const glm::vec2& uvMax = glm::vec2(1.0f));
+
+private:
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<StreamingVertexBuffer> m_VertexBuffer;
+	std::shared_ptr<Shader> m_Shader;
+
+	unsigned int m_WhiteTexture;
+
+	//	Where the current batch is written; it points into the mapped vertex buffer between BeginBatch() and EndBatch().
+	QuadVertex* m_Vertices;
+	unsigned int m_QuadCount;
+
+	std::array<unsigned int, MaxTextureSlots> m_TextureSlots;
+	unsigned int m_TextureSlotCount;
+	//	The smaller of MaxTextureSlots and what the GPU supports.
+	unsigned int m_TextureSlotLimit;
+
+	TextureMode m_TextureMode;
+	std::shared_ptr<Shader> m_BindlessShader;
+	//	The shader storage buffer the batch's handles are uploaded to.
+	unsigned int m_HandleBuffer;
+	//	Bindless mode's slots: the textures of the batch in order, and the slot of each.
+	std::vector<unsigned int> m_BindlessTextures;
+	std::unordered_map<unsigned int, unsigned int> m_BindlessSlots;
+	std::vector<GLuint64> m_Handles;
+
+	Stats m_Stats;
+
+	//	The texture slot of each sprite passed to DrawQuads(); kept so it isn't reallocated every frame.
+	std::vector<float> m_SpriteSlots;
+};
@@ -1,79 +1,101 @@
 #include "Shader.h"
 #include "Renderer.h"
+#include "GLStateCache.h"
+#include "Instrumentor.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderCompiler.h"
+#include "FrameUniforms.h"
 
+#include <algorithm>
 #include <iostream>
-#include <sstream>
-#include <fstream>
 #include <string>
+#include <vector>
+#include <chrono>
 
 //"res/shaders/ep11-14/Basic.shader" ; GLCall(glUseProgram(shader_program));
 
-Shader::Shader(const std::string& filePath)
-    : m_FilePath(filePath)
+Shader::Shader(const std::string& filePath, ShaderLoad load, const std::vector<std::string>& defines)
+    : m_FilePath(filePath), m_Compiler(nullptr), m_PendingStages{}, m_CreationTime(0.0),
+    m_FallbackMatrix(1.0f), m_FallbackUsesCamera(true), m_Keywords(defines)
 {
-    ShaderProgramSource source = ParseShader(filePath);
-    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    PROFILE_FUNCTION();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    ShaderProgramSource source = ParseShader(filePath, defines);
+
+    //  A binary the driver made for the same sources skips compiling and linking.
+    ProgramBinaryCache* cache = ProgramBinaryCache::Get();
+    std::string key;
+    m_RendererID = 0;
+    if (cache)
+    {
+        key = cache->MakeKey(std::vector<std::string>(std::begin(source.Sources), std::end(source.Sources)));
+        m_RendererID = cache->Load(key);
+    }
+
+    bool warm = m_RendererID != 0;
+    ShaderCompiler* compiler = load == ShaderLoad::Async && !source.HasStage(ShaderStage::Compute) ? ShaderCompiler::Get() : nullptr;
+    if (!warm && compiler)
+    {
+        //  The binary is stored and the time reported by Finish(), once the program is linked.
+        StartCreateShader(source);
+        m_SourceFiles = std::move(source.Files);
+        m_CacheKey = key;
+        m_Compiler = compiler;
+        m_Compiler->Add(this);
+        m_CreationTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        return;
+    }
+
+    if (!warm)
+    {
+        m_SourceFiles = std::move(source.Files);
+        m_RendererID = CreateShader(source);
+        if (cache)
+            cache->Store(key, m_RendererID);
+    }
+    BindUniformBlocks();
+
+    if (cache)
+        cache->RecordCreation(warm, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
 }
 
 
 Shader::~Shader()
 {
+    if (m_Compiler)
+    {
+        m_Compiler->Remove(this);
+        for (unsigned int stage : m_PendingStages)
+        {
+            GLCall(glDeleteShader(stage));
+        }
+    }
+
     //  Only relevant if the m_RendererID is not 0 -- it was successful
+    GLStateCache::Get().OnDeleteProgram(m_RendererID);
     GLCall(glDeleteProgram(m_RendererID));
 }
 
 
-ShaderProgramSource Shader::ParseShader(const std::string& filePath)
+ShaderProgramSource Shader::ParseShader(const std::string& filePath, const std::vector<std::string>& defines)
 {
-    std::fstream stream(filePath);
-
-    enum class ShaderType
-    {
-        NONE = -1, VERTEX = 0, FRAGMENT = 1
-    };
-
-    std::string line;
-    std::stringstream ss[2];
-    ShaderType type = ShaderType::NONE;
-    //  While it does not return 0, that is, there are still lines to read
-    //  It is inside the <string> header
-    while (getline(stream, line))
-    {
-        //  If the line contains '#shader' and not an invalid string position in the file
-        //  if it finds the string, it returns the position of it
-        if (line.find("#shader") != std::string::npos)
-        {
-            //  Since it's found '#shader', then check if it's 'vertex'
-            if (line.find("vertex") != std::string::npos)
-            {
-                // set mode to vertex
-                type = ShaderType::VERTEX;
-            }
-            //  if line has frament
-            else if (line.find("fragment") != std::string::npos)
-            {
-                //  set mode to fragment
-                type = ShaderType::FRAGMENT;
-            }
-        }
-        else
-        {
-            //    If the line is any kind of code
-            //  Using the arrays and the Enum type as an index to automate it
-            ss[(int)type] << line << "\n";
-        }
-
-    }
+    PROFILE_FUNCTION();
 
-    return { ss[0].str(), ss[1].str() };
+    //  A file that can't be read leaves every stage empty, so the program has nothing to link.
+    ShaderProgramSource source;
+    ShaderPreprocessor(defines).Process(filePath, source);
+    return source;
 }
 
 
 
-unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+unsigned int Shader::CompileShader(ShaderStage stage, const std::string& source)
 {
+    PROFILE_FUNCTION();
+
     //GLCall(unsigned int id = glCreateShader(type));
-    GLCall(unsigned int id = glCreateShader(type));
+    GLCall(unsigned int id = glCreateShader(ShaderPreprocessor::GetGLStage(stage)));
 
     /**
     *   Because GL uses a const char array rather than STL string
@@ -93,6 +115,18 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
     GLCall(glShaderSource(id, 1, &src, nullptr));
     GLCall(glCompileShader(id));
 
+    if (!CheckCompileStatus(id, stage))
+    {
+        //  Then delete shader
+        glDeleteShader(id);
+        return 0;
+    }
+
+    return id;
+}
+
+bool Shader::CheckCompileStatus(unsigned int id, ShaderStage stage)
+{
     //  TODO: Error Handling / Debugging
     int result;
     //  `glGetShader` is the actual function, while iv specify
@@ -109,29 +143,39 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 
         char* message = (char*)alloca(length * sizeof(char));
         GLCall(glGetShaderInfoLog(id, length, &length, message));
-        std::cout << "Failed to Compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << "\n";
-        std::cout << message << "\n";
-
-        //  Then delete shader
-        glDeleteShader(id);
-        return 0;
+        std::cout << "Failed to Compile " << ShaderPreprocessor::GetStageName(stage) << "\n";
+        std::cout << ShaderPreprocessor::MapLog(message, m_SourceFiles) << "\n";
+        return false;
     }
 
-    return id;
+    return true;
 }
 
 
 
-unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+unsigned int Shader::CreateShader(const ShaderProgramSource& source)
 {
+    PROFILE_FUNCTION();
+
     //  Note it returns an unsigned integer, unlike the glGenBuffer 
     unsigned int program = glCreateProgram();
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    unsigned int stages[(int)ShaderStage::Count] = {};
+    for (int i = 0; i < (int)ShaderStage::Count; i++)
+    {
+        if (source.HasStage((ShaderStage)i))
+            stages[i] = CompileShader((ShaderStage)i, source.Sources[i]);
 
-    //  Attach the compiled source to the program
-    GLCall(glAttachShader(program, vs));
-    GLCall(glAttachShader(program, fs));
+        //  Attach the compiled source to the program
+        if (stages[i])
+        {
+            GLCall(glAttachShader(program, stages[i]));
+        }
+    }
+    //  Without the hint, drivers may not keep what glGetProgramBinary() needs.
+    if (ProgramBinaryCache::Get())
+    {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
     GLCall(glLinkProgram(program));
     GLCall(glValidateProgram(program));
 
@@ -140,52 +184,242 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
     //  This is better than something like glDetach since the latter deletes the source code from
     //  memory but this source code can be used in debugging, and the gain from deleting
     //  the source is not a lot.
-    GLCall(glDeleteShader(vs));
-    GLCall(glDeleteShader(fs));
+    for (unsigned int stage : stages)
+    {
+        if (stage)
+        {
+            GLCall(glDeleteShader(stage));
+        }
+    }
 
     return program;
 }
 
 
+void Shader::StartCreateShader(const ShaderProgramSource& source)
+{
+    PROFILE_FUNCTION();
+
+    //  The same calls as CreateShader(), minus every status query and glValidateProgram, which would wait for the driver.
+    GLCall(m_RendererID = glCreateProgram());
+    for (int i = 0; i < (int)ShaderStage::Count; i++)
+    {
+        if (!source.HasStage((ShaderStage)i))
+            continue;
+
+        const char* src = source.Sources[i].c_str();
+        GLCall(m_PendingStages[i] = glCreateShader(ShaderPreprocessor::GetGLStage((ShaderStage)i)));
+        GLCall(glShaderSource(m_PendingStages[i], 1, &src, nullptr));
+        GLCall(glCompileShader(m_PendingStages[i]));
+        GLCall(glAttachShader(m_RendererID, m_PendingStages[i]));
+    }
+    if (ProgramBinaryCache::Get())
+    {
+        GLCall(glProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+    GLCall(glLinkProgram(m_RendererID));
+}
+
+bool Shader::IsLinkDone() const
+{
+    if (!ShaderCompiler::IsParallelSupported())
+        return true;
+
+    int done = GL_FALSE;
+    GLCall(glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &done));
+    return done == GL_TRUE;
+}
+
+void Shader::Finish()
+{
+    if (IsReady())
+        return;
+
+    PROFILE_FUNCTION();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //  These are what wait, if the driver isn't done yet.
+    for (int i = 0; i < (int)ShaderStage::Count; i++)
+    {
+        if (m_PendingStages[i])
+            CheckCompileStatus(m_PendingStages[i], (ShaderStage)i);
+    }
+    GLCall(glValidateProgram(m_RendererID));
+    for (unsigned int& stage : m_PendingStages)
+    {
+        if (stage)
+        {
+            GLCall(glDeleteShader(stage));
+        }
+        stage = 0;
+    }
+
+    m_Compiler->OnFinished(this);
+    m_Compiler = nullptr;
+    BindUniformBlocks();
+
+    //  The uniforms it was given while compiling, now that they have locations.
+    Bind();
+    for (auto& uniform : m_PendingUniforms)
+        uniform.second();
+    m_PendingUniforms.clear();
+
+    ProgramBinaryCache* cache = ProgramBinaryCache::Get();
+    if (cache)
+    {
+        cache->Store(m_CacheKey, m_RendererID);
+        m_CreationTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        cache->RecordCreation(false, m_CreationTime);
+    }
+}
+
+std::shared_ptr<Shader> Shader::GetVariant(const std::vector<std::string>& keywords, ShaderLoad load)
+{
+    std::vector<std::string> sorted = keywords;
+    std::string key = MakeVariantKey(sorted);
+
+    auto it = m_Variants.find(key);
+    if (it != m_Variants.end())
+    {
+        if (load == ShaderLoad::Sync)
+            it->second->Finish();
+        return it->second;
+    }
+
+    PROFILE_SCOPE("Shader::GetVariant compile");
+    auto variant = std::make_shared<Shader>(m_FilePath, load, sorted);
+    m_Variants.emplace(key, variant);
+    return variant;
+}
+
+std::string Shader::MakeVariantKey(std::vector<std::string>& keywords)
+{
+    //  So the same set in a different order is the same variant, and the same program binary.
+    std::sort(keywords.begin(), keywords.end());
+    keywords.erase(std::unique(keywords.begin(), keywords.end()), keywords.end());
+
+    std::string key;
+    for (const std::string& keyword : keywords)
+        key += keyword + ' ';
+    return key;
+}
+
+int Shader::GetMaxTextureUnits()
+{
+    static int maxUnits = 0;
+    if (maxUnits == 0)
+    {
+        GLCall(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits));
+    }
+    return maxUnits;
+}
+
+void Shader::BindUniformBlocks()
+{
+    //  Not kept in program binaries everywhere, so set for every program, however it was made.
+    GLCall(unsigned int frame = glGetUniformBlockIndex(m_RendererID, FrameUniforms::BlockName));
+    if (frame != GL_INVALID_INDEX)
+    {
+        GLCall(glUniformBlockBinding(m_RendererID, frame, FrameUniforms::Binding));
+    }
+}
+
+void Shader::SetFallbackMVP() const
+{
+    //  A u_Model is placed with the frame's camera, as the real program would.
+    if (m_FallbackUsesCamera)
+        m_Compiler->SetFallbackMVP(FrameUniforms::Get().GetData().ViewProjection * m_FallbackMatrix);
+    else
+        m_Compiler->SetFallbackMVP(m_FallbackMatrix);
+}
+
 void Shader::Bind() const
 {
-    GLCall(glUseProgram(m_RendererID));
+    if (m_Compiler)
+    {
+        SetFallbackMVP();
+        return;
+    }
+    GLStateCache::Get().UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-    GLCall(glUseProgram(0));
+    GLStateCache::Get().UseProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int value)
 {
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, value] { SetUniform1i(name, value); };
+        return;
+    }
+
     GLCall(glUniform1i(GetUniformLocation(name), value));
 }
 
 void Shader::SetUniform1iv(const std::string& name, int* values)
 {
+    //  How many values there are isn't known, so they can't be kept for later.
+    Finish();
     //  Not required to cast to GLint *
     std::cout << "Size: " << sizeof(values) << "\n";
     GLCall(glUniform1iv(GetUniformLocation(name), sizeof(values) - 1, (GLint*)values));
 }
 
+void Shader::SetUniform1iv(const std::string& name, int count, const int* values)
+{
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, copy = std::vector<int>(values, values + count)] { SetUniform1iv(name, (int)copy.size(), copy.data()); };
+        return;
+    }
+
+    GLCall(glUniform1iv(GetUniformLocation(name), count, (const GLint*)values));
+}
+
 void Shader::SetUniform1f(const std::string& name, float value)
 {
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, value] { SetUniform1f(name, value); };
+        return;
+    }
+
     GLCall(glUniform1f(GetUniformLocation(name), value));
 }
 
 void Shader::SetUniform2f(const std::string& name, const glm::vec2& value)
 {
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, value] { SetUniform2f(name, value); };
+        return;
+    }
+
     GLCall(glUniform2f(GetUniformLocation(name), value.x, value.y));
 }
 
 void Shader::SetUniform3f(const std::string& name, const glm::vec3& value)
 {
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, value] { SetUniform3f(name, value); };
+        return;
+    }
+
     GLCall(glUniform3f(GetUniformLocation(name), value.x, value.y, value.z));
 }
 
 void Shader::SetUniform4f(const std::string& name, const glm::vec4& value)
 {
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, value] { SetUniform4f(name, value); };
+        return;
+    }
+
     /**
     *   Setting up the Uniform.
     *
@@ -206,6 +440,12 @@ void Shader::SetUniform4f(const std::string& name, const glm::vec4& value)
 
 void Shader::SetUniformMat3(const std::string& name, const glm::mat3& matrix)
 {
+    if (!IsReady())
+    {
+        m_PendingUniforms[name] = [this, name, matrix] { SetUniformMat3(name, matrix); };
+        return;
+    }
+
     //  'v' specifies that it's an array
     /**
     *   p1: Uniform name
@@ -218,6 +458,19 @@ void Shader::SetUniformMat3(const std::string& name, const glm::mat3& matrix)
 
 void Shader::SetUniformMat4(const std::string& name, const glm::mat4& matrix)
 {
+    if (!IsReady())
+    {
+        //  So the fallback is drawn where the real program would be.
+        if (name == "u_MVP" || name == "u_Model")
+        {
+            m_FallbackMatrix = matrix;
+            m_FallbackUsesCamera = name == "u_Model";
+            SetFallbackMVP();
+        }
+        m_PendingUniforms[name] = [this, name, matrix] { SetUniformMat4(name, matrix); };
+        return;
+    }
+
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
@@ -1,14 +1,23 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <functional>
 #include <unordered_map>
 
 #include "glm/glm.hpp"
+#include "ShaderPreprocessor.h"
 
-struct ShaderProgramSource
+class ShaderCompiler;
+
+enum class ShaderLoad
 {
-	std::string VertexSource;
-	std::string FragmentSource;
+	//	Compiled and linked before the constructor returns.
+	Sync,
+	//	Compiling and linking are only started; the current ShaderCompiler finishes the shader once the driver is done,
+	//	and until then it's drawn with the compiler's fallback program. The same as Sync if there is no compiler.
+	Async
 };
 
 
@@ -21,16 +30,60 @@ private:
 	//	the mutable keyword makes this member modifieable by a const method/function.
 	mutable std::unordered_map<std::string, int> m_UniformLocationCache;
 
+	//	While an Async shader is compiling: the compiler finishing it, the shader objects attached to the program,
+	//	the key of its program binary, and the last value given to each uniform, to be set once it's linked.
+	ShaderCompiler* m_Compiler;
+	unsigned int m_PendingStages[(int)ShaderStage::Count];
+	//	The files its #line directives number, to name them in the compile logs.
+	std::vector<std::string> m_SourceFiles;
+	std::string m_CacheKey;
+	std::unordered_map<std::string, std::function<void()>> m_PendingUniforms;
+	//	The CPU time the constructor took, so Finish() can add its own and report both.
+	double m_CreationTime;
+	//	What the fallback draws with until then: the last u_MVP, or the frame's camera times the last u_Model.
+	glm::mat4 m_FallbackMatrix;
+	bool m_FallbackUsesCamera;
+
+	//	The defines it was compiled with, and the variants GetVariant() compiled from the same file, by their keywords.
+	std::vector<std::string> m_Keywords;
+	std::unordered_map<std::string, std::shared_ptr<Shader>> m_Variants;
+
 public:
-	Shader(const std::string& filePath);
+	//	`defines` ("NAME" or "NAME=VALUE") are put at the top of every stage; see ShaderPreprocessor.
+	//	A shader with a compute stage is always loaded Sync, the fallback program can't stand in for it.
+	Shader(const std::string& filePath, ShaderLoad load = ShaderLoad::Sync, const std::vector<std::string>& defines = {});
 	~Shader();
 
+	//	False while an Async shader is still compiling; binding it binds the fallback program then.
+	inline bool IsReady() const { return m_Compiler == nullptr; }
+	//	Waits for the driver to compile and link the program; nothing to do if it's ready.
+	void Finish();
+
 	void Bind() const;
 	void Unbind() const;
 
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
+	/**
+	*	The program compiled from the same file with `keywords` defined ("NAME" or "NAME=VALUE", in any order),
+	*	compiled the first time it's asked for and kept by this shader from then on. Only what the keywords turn on
+	*	is in the program, e.g. res/shaders/Batch/Batch.shader sizes its sampler array to MAX_TEXTURES=N.
+	*	The keywords replace the ones this shader has, if it's a variant itself. This shader has to be compiled to
+	*	be asked, so a variant on its own is better had from AssetManager::GetShaderVariant().
+	*/
+	std::shared_ptr<Shader> GetVariant(const std::vector<std::string>& keywords, ShaderLoad load = ShaderLoad::Sync);
+	//	Sorts `keywords` and drops the repeated ones, so a set is the same variant in any order; returns them as one key.
+	static std::string MakeVariantKey(std::vector<std::string>& keywords);
+	inline const std::vector<std::string>& GetKeywords() const { return m_Keywords; }
+	inline const std::unordered_map<std::string, std::shared_ptr<Shader>>& GetVariants() const { return m_Variants; }
+
+	//	GL_MAX_TEXTURE_IMAGE_UNITS, what a sampler array in the fragment stage can have at most; needs a context.
+	static int GetMaxTextureUnits();
+
 	//	Set Uniforms
 	void SetUniform1i(const std::string& name, int value);
 	void SetUniform1iv(const std::string& name, int* values);
+	void SetUniform1iv(const std::string& name, int count, const int* values);
 	void SetUniform1f(const std::string& name, float value);
 	void SetUniform2f(const std::string& name, const glm::vec2& value);
 	void SetUniform3f(const std::string& name, const glm::vec3& value);
@@ -42,9 +95,23 @@ public:
 
 
 private:
-	ShaderProgramSource ParseShader(const std::string& filePath);
-	unsigned int CompileShader(unsigned int type, const std::string& source);
-	unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+	friend class ShaderCompiler;
+	//	Whether the driver has linked the program, without waiting for it; always true without KHR_parallel_shader_compile.
+	bool IsLinkDone() const;
+	//	Starts compiling the stages and linking them, and asks for nothing that would wait for the driver.
+	void StartCreateShader(const ShaderProgramSource& source);
+	//	Binds the program's Frame block, if it has one, to FrameUniforms::Binding.
+	void BindUniformBlocks();
+	//	Binds the fallback program with the matrix this shader would be drawn with.
+	void SetFallbackMVP() const;
+	//	Prints the log of a stage that didn't compile, with file names in it; false if it didn't.
+	bool CheckCompileStatus(unsigned int id, ShaderStage stage);
+
+	//	Reads the file (and its includes) from the current AssetPack if it has it, or from disk.
+	ShaderProgramSource ParseShader(const std::string& filePath, const std::vector<std::string>& defines);
+	unsigned int CompileShader(ShaderStage stage, const std::string& source);
+	//	Links every stage `source` has.
+	unsigned int CreateShader(const ShaderProgramSource& source);
 
 	//	Used to receive the OpenGL locations.
 	//	It's marked as const since it's not modifying any other memeber in this class.
@@ -0,0 +1,136 @@
+#include "ShaderCompiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Renderer.h"
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "imgui/imgui.h"
+
+
+static thread_local ShaderCompiler* s_Current = nullptr;
+
+//  Every shader of res/shaders takes its position at location 0; Shader works out the matrix from its u_MVP or u_Model.
+static const char* FallbackVertexSource = R"(#version 330 core
+layout(location=0) in vec4 a_Position;
+uniform mat4 u_MVP;
+void main()
+{
+    gl_Position = u_MVP * a_Position;
+}
+)";
+
+static const char* FallbackFragmentSource = R"(#version 330 core
+layout(location=0) out vec4 o_Color;
+void main()
+{
+    o_Color = vec4(0.35, 0.35, 0.35, 1.0);
+}
+)";
+
+static unsigned int CompileFallbackStage(unsigned int type, const char* source)
+{
+    GLCall(unsigned int id = glCreateShader(type));
+    GLCall(glShaderSource(id, 1, &source, nullptr));
+    GLCall(glCompileShader(id));
+    return id;
+}
+
+ShaderCompiler::ShaderCompiler()
+    : m_FallbackProgram(0), m_FallbackMVPLocation(-1)
+{
+    //  As many threads as the driver likes.
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+    }
+
+    //  Small enough that compiling it right away doesn't matter.
+    unsigned int vs = CompileFallbackStage(GL_VERTEX_SHADER, FallbackVertexSource);
+    unsigned int fs = CompileFallbackStage(GL_FRAGMENT_SHADER, FallbackFragmentSource);
+    GLCall(m_FallbackProgram = glCreateProgram());
+    GLCall(glAttachShader(m_FallbackProgram, vs));
+    GLCall(glAttachShader(m_FallbackProgram, fs));
+    GLCall(glLinkProgram(m_FallbackProgram));
+    GLCall(glDeleteShader(vs));
+    GLCall(glDeleteShader(fs));
+    GLCall(m_FallbackMVPLocation = glGetUniformLocation(m_FallbackProgram, "u_MVP"));
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    //  Shaders still compiling are finished, so none of them is left pointing at this.
+    while (!m_Pending.empty())
+        m_Pending.back()->Finish();
+
+    if (s_Current == this)
+        s_Current = nullptr;
+    GLStateCache::Get().OnDeleteProgram(m_FallbackProgram);
+    GLCall(glDeleteProgram(m_FallbackProgram));
+}
+
+bool ShaderCompiler::IsParallelSupported()
+{
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+ShaderCompiler* ShaderCompiler::Get()
+{
+    return s_Current;
+}
+
+void ShaderCompiler::MakeCurrent(ShaderCompiler* compiler)
+{
+    s_Current = compiler;
+}
+
+void ShaderCompiler::Add(Shader* shader)
+{
+    m_Pending.push_back(shader);
+    m_Stats.Started++;
+}
+
+void ShaderCompiler::OnFinished(Shader* shader)
+{
+    Remove(shader);
+    m_Stats.Finished++;
+}
+
+void ShaderCompiler::Remove(Shader* shader)
+{
+    m_Pending.erase(std::remove(m_Pending.begin(), m_Pending.end(), shader), m_Pending.end());
+}
+
+void ShaderCompiler::Update()
+{
+    if (m_Pending.empty())
+        return;
+
+    //  Finish() takes the shader out of m_Pending.
+    std::vector<Shader*> pending = m_Pending;
+    for (Shader* shader : pending)
+    {
+        if (shader->IsLinkDone())
+            shader->Finish();
+    }
+    if (!m_Pending.empty())
+        m_Stats.FallbackFrames++;
+}
+
+void ShaderCompiler::SetFallbackMVP(const glm::mat4& mvp)
+{
+    GLStateCache::Get().UseProgram(m_FallbackProgram);
+    GLCall(glUniformMatrix4fv(m_FallbackMVPLocation, 1, GL_FALSE, &mvp[0][0]));
+}
+
+void ShaderCompiler::OnImGuiRender() const
+{
+    ImGui::Text("Async shaders: %u started, %u finished, %u compiling; %u frames used the fallback",
+        m_Stats.Started, m_Stats.Finished, GetPendingCount(), m_Stats.FallbackFrames);
+    ImGui::Text("Polling: %s", IsParallelSupported() ? "GL_COMPLETION_STATUS_KHR" : "none (finished at the next frame)");
+}
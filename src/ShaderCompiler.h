@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+class Shader;
+
+/**
+*	Finishes the shaders that were created with ShaderLoad::Async.
+*
+*	An async Shader only starts compiling and linking: it doesn't ask for the compile or link status, which is what
+*	makes the driver wait for them. So a test can start every shader it needs in its constructor, and the driver
+*	compiles them all at once on its own threads. Until its program is linked, binding a Shader binds the fallback
+*	program instead, which draws the geometry in flat grey with the MVP the Shader was given; the other uniforms it's
+*	given are kept and set on the real program once it's there.
+*
+*	Update() is called once a frame and finishes every shader whose program is linked. With KHR_parallel_shader_compile
+*	(or the ARB version of it), it asks GL_COMPLETION_STATUS_KHR, which never waits, so a frame never stalls on a
+*	shader. Without it, there's no way to ask without waiting, so every started shader is finished at the next Update();
+*	that's still one wait for all of them, after the driver had them all to work on.
+*/
+class ShaderCompiler
+{
+public:
+	struct Stats
+	{
+		unsigned int Started = 0;
+		unsigned int Finished = 0;
+		//	Frames in which at least one shader was still drawn with the fallback.
+		unsigned int FallbackFrames = 0;
+	};
+
+	ShaderCompiler();
+	~ShaderCompiler();
+
+	ShaderCompiler(const ShaderCompiler&) = delete;
+	ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+	//	Whether the driver can tell if a program is linked without waiting for it.
+	static bool IsParallelSupported();
+
+	//	The compiler of this thread's context, or null, in which case ShaderLoad::Async is the same as Sync.
+	static ShaderCompiler* Get();
+	static void MakeCurrent(ShaderCompiler* compiler);
+
+	void Update();
+
+	inline unsigned int GetFallbackProgram() const { return m_FallbackProgram; }
+	//	Binds the fallback program and sets the matrix it transforms positions with.
+	void SetFallbackMVP(const glm::mat4& mvp);
+
+	inline unsigned int GetPendingCount() const { return (unsigned int)m_Pending.size(); }
+	inline const Stats& GetStats() const { return m_Stats; }
+	void OnImGuiRender() const;
+
+private:
+	friend class Shader;
+	void Add(Shader* shader);
+	void OnFinished(Shader* shader);
+	//	For shaders deleted before they were finished.
+	void Remove(Shader* shader);
+
+private:
+	std::vector<Shader*> m_Pending;
+	unsigned int m_FallbackProgram;
+	int m_FallbackMVPLocation;
+	Stats m_Stats;
+};
@@ -0,0 +1,344 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Renderer.h"
+#include "AssetPack.h"
+#include "Instrumentor.h"
+
+
+static std::unordered_map<std::string, std::string> s_Files;
+static ShaderPreprocessor::Stats s_Stats;
+
+static const char* StageNames[(int)ShaderStage::Count] = { "vertex", "fragment", "geometry", "compute" };
+
+static const char* SkipSpaces(const char* begin, const char* end)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+        begin++;
+    return begin;
+}
+
+static bool IsWord(const char* begin, const char* end, const char* word)
+{
+    size_t length = strlen(word);
+    return (size_t)(end - begin) == length && memcmp(begin, word, length) == 0;
+}
+
+//  `name` relative to the directory of `from`, without any "dir/.." in it, so a file is one path however it's included.
+static std::string ResolveInclude(const std::string& from, const std::string& name)
+{
+    std::string path = AssetPack::NormalizePath(from);
+    size_t slash = path.rfind('/');
+    path = (slash != std::string::npos ? path.substr(0, slash + 1) : std::string()) + AssetPack::NormalizePath(name);
+
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size())
+    {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos)
+            end = path.size();
+        std::string part = path.substr(start, end - start);
+        if (part == ".." && !parts.empty() && parts.back() != "..")
+            parts.pop_back();
+        else if (!part.empty() && part != ".")
+            parts.push_back(part);
+        start = end + 1;
+    }
+
+    std::string resolved;
+    for (const std::string& part : parts)
+        resolved += (resolved.empty() ? "" : "/") + part;
+    return resolved;
+}
+
+
+ShaderPreprocessor::ShaderPreprocessor(const std::vector<std::string>& defines)
+    : m_Source(nullptr), m_Stage(-1), m_Started{}, m_NextLine{}, m_NextFile{}
+{
+    for (const std::string& define : defines)
+    {
+        size_t equals = define.find('=');
+        if (equals == std::string::npos)
+            m_Defines += "#define " + define + " 1\n";
+        else
+            m_Defines += "#define " + define.substr(0, equals) + " " + define.substr(equals + 1) + "\n";
+    }
+}
+
+bool ShaderPreprocessor::Process(const std::string& filePath, ShaderProgramSource& source)
+{
+    PROFILE_FUNCTION();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::string* contents = ReadFile(filePath);
+    if (!contents)
+    {
+        std::cout << "Could not read shader " << filePath << "\n";
+        return false;
+    }
+
+    //  Not a reference into source.Files, which the includes grow.
+    std::string path = AssetPack::NormalizePath(filePath);
+    source = ShaderProgramSource();
+    source.Files.push_back(path);
+    m_Source = &source;
+    m_Stage = -1;
+    for (int i = 0; i < (int)ShaderStage::Count; i++)
+    {
+        m_Started[i] = false;
+        m_Included[i].clear();
+    }
+
+    ProcessFile(path, *contents, 0, 0);
+    m_Source = nullptr;
+
+    s_Stats.Shaders++;
+    s_Stats.Time += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return true;
+}
+
+void ShaderPreprocessor::ProcessFile(const std::string& filePath, const std::string& contents, int fileIndex, int depth)
+{
+    const char* p = contents.data();
+    const char* end = p + contents.size();
+
+    for (int line = 1; p < end; line++)
+    {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+        const char* next = lineEnd ? lineEnd + 1 : end;
+        if (!lineEnd)
+            lineEnd = end;
+        if (lineEnd > p && lineEnd[-1] == '\r')
+            lineEnd--;
+
+        const char* begin = p;
+        p = next;
+
+        const char* hash = SkipSpaces(begin, lineEnd);
+        if (hash == lineEnd || *hash != '#')
+        {
+            //  Lines before the first #shader belong to no stage.
+            if (m_Stage >= 0)
+                Emit(begin, lineEnd, line, fileIndex);
+            continue;
+        }
+
+        const char* word = SkipSpaces(hash + 1, lineEnd);
+        const char* wordEnd = word;
+        while (wordEnd < lineEnd && isalpha((unsigned char)*wordEnd))
+            wordEnd++;
+        const char* argument = SkipSpaces(wordEnd, lineEnd);
+        const char* argumentEnd = lineEnd;
+        while (argumentEnd > argument && (argumentEnd[-1] == ' ' || argumentEnd[-1] == '\t'))
+            argumentEnd--;
+
+        if (IsWord(word, wordEnd, "shader"))
+        {
+            if (depth > 0)
+            {
+                std::cout << filePath << ":" << line << ": #shader in an included file is ignored\n";
+                continue;
+            }
+
+            m_Stage = -1;
+            for (int i = 0; i < (int)ShaderStage::Count; i++)
+            {
+                if (IsWord(argument, argumentEnd, StageNames[i]))
+                    m_Stage = i;
+            }
+            if (m_Stage < 0)
+                std::cout << filePath << ":" << line << ": unknown stage '" << std::string(argument, argumentEnd) << "', its lines are dropped\n";
+        }
+        else if (IsWord(word, wordEnd, "include"))
+        {
+            if (m_Stage < 0)
+                continue;
+
+            if (argumentEnd - argument < 2 || !((*argument == '"' && argumentEnd[-1] == '"') || (*argument == '<' && argumentEnd[-1] == '>')))
+            {
+                std::cout << filePath << ":" << line << ": #include expects \"file\"\n";
+                continue;
+            }
+
+            std::string includePath = ResolveInclude(filePath, std::string(argument + 1, argumentEnd - 1));
+            std::vector<std::string>& included = m_Included[m_Stage];
+            if (std::find(included.begin(), included.end(), includePath) != included.end())
+                continue;
+
+            const std::string* includeContents = ReadFile(includePath);
+            if (!includeContents)
+            {
+                std::cout << filePath << ":" << line << ": could not open include " << includePath << "\n";
+                continue;
+            }
+            included.push_back(includePath);
+            ProcessFile(includePath, *includeContents, GetFileIndex(includePath), depth + 1);
+        }
+        else if (IsWord(word, wordEnd, "version") && depth > 0)
+        {
+            //  The file including it has one already.
+            continue;
+        }
+        else if (m_Stage >= 0)
+        {
+            Emit(begin, lineEnd, line, fileIndex);
+        }
+    }
+}
+
+void ShaderPreprocessor::Emit(const char* begin, const char* end, int line, int fileIndex)
+{
+    std::string& source = m_Source->Sources[m_Stage];
+    if (!m_Started[m_Stage])
+    {
+        //  #version has to come first, so blank lines before it are dropped and the defines go right after it.
+        const char* first = SkipSpaces(begin, end);
+        if (first == end)
+            return;
+
+        m_Started[m_Stage] = true;
+        m_NextLine[m_Stage] = -1;
+        if (first[0] == '#' && IsWord(first + 1, std::min(first + 8, end), "version"))
+        {
+            source.append(begin, end);
+            source += '\n';
+            source += m_Defines;
+            return;
+        }
+        source += m_Defines;
+    }
+
+    //  Only where the lines stop following each other: after the defines, and around #shader, #include and the like.
+    if (line != m_NextLine[m_Stage] || fileIndex != m_NextFile[m_Stage])
+        AddLineDirective(line, fileIndex);
+    m_NextLine[m_Stage] = line + 1;
+    m_NextFile[m_Stage] = fileIndex;
+
+    source.append(begin, end);
+    source += '\n';
+}
+
+void ShaderPreprocessor::AddLineDirective(int line, int fileIndex)
+{
+    //  The GLSL 3.30+ meaning: the line after the directive is `line`.
+    std::string& source = m_Source->Sources[m_Stage];
+    source += "#line ";
+    source += std::to_string(line);
+    source += ' ';
+    source += std::to_string(fileIndex);
+    source += '\n';
+}
+
+int ShaderPreprocessor::GetFileIndex(const std::string& filePath)
+{
+    std::vector<std::string>& files = m_Source->Files;
+    auto it = std::find(files.begin(), files.end(), filePath);
+    if (it != files.end())
+        return (int)(it - files.begin());
+    files.push_back(filePath);
+    return (int)files.size() - 1;
+}
+
+std::string ShaderPreprocessor::MapLog(const std::string& log, const std::vector<std::string>& files)
+{
+    std::string mapped;
+    mapped.reserve(log.size());
+
+    size_t start = 0;
+    while (start < log.size())
+    {
+        size_t end = log.find('\n', start);
+        end = end == std::string::npos ? log.size() : end + 1;
+
+        //  NVIDIA starts the line with "0(12)", Mesa with "0:12(5)", AMD and Intel with "ERROR: 0:12".
+        size_t number = start;
+        for (const char* prefix : { "ERROR: ", "WARNING: " })
+        {
+            if (log.compare(start, strlen(prefix), prefix) == 0)
+                number = start + strlen(prefix);
+        }
+        size_t numberEnd = number;
+        while (numberEnd < end && isdigit((unsigned char)log[numberEnd]))
+            numberEnd++;
+
+        size_t index = numberEnd > number ? (size_t)std::stoul(log.substr(number, numberEnd - number)) : files.size();
+        if (index < files.size() && numberEnd < end && (log[numberEnd] == '(' || log[numberEnd] == ':'))
+        {
+            mapped.append(log, start, number - start);
+            mapped += files[index];
+            mapped.append(log, numberEnd, end - numberEnd);
+        }
+        else
+        {
+            mapped.append(log, start, end - start);
+        }
+        start = end;
+    }
+
+    return mapped;
+}
+
+const std::string* ShaderPreprocessor::ReadFile(const std::string& filePath)
+{
+    std::string path = AssetPack::NormalizePath(filePath);
+    auto it = s_Files.find(path);
+    if (it != s_Files.end())
+    {
+        s_Stats.CacheHits++;
+        return &it->second;
+    }
+
+    std::string contents;
+    AssetPack::Data data;
+    AssetPack* pack = AssetPack::Get();
+    if (pack && pack->Load(path, data))
+    {
+        contents.assign((const char*)data.Bytes, data.Size);
+    }
+    else
+    {
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream)
+            return nullptr;
+        contents.resize((size_t)stream.tellg());
+        stream.seekg(0);
+        stream.read(&contents[0], contents.size());
+    }
+
+    s_Stats.FilesRead++;
+    //  The map's nodes never move, so the pointer stays valid until ClearCache().
+    return &s_Files.emplace(path, std::move(contents)).first->second;
+}
+
+void ShaderPreprocessor::ClearCache()
+{
+    s_Files.clear();
+}
+
+const ShaderPreprocessor::Stats& ShaderPreprocessor::GetStats()
+{
+    return s_Stats;
+}
+
+const char* ShaderPreprocessor::GetStageName(ShaderStage stage)
+{
+    return StageNames[(int)stage];
+}
+
+unsigned int ShaderPreprocessor::GetGLStage(ShaderStage stage)
+{
+    switch (stage)
+    {
+    case ShaderStage::Vertex:   return GL_VERTEX_SHADER;
+    case ShaderStage::Fragment: return GL_FRAGMENT_SHADER;
+    case ShaderStage::Geometry: return GL_GEOMETRY_SHADER;
+    case ShaderStage::Compute:  return GL_COMPUTE_SHADER;
+    default:                    return 0;
+    }
+}
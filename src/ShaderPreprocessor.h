@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+//	The stages a .shader file can have, each after a `#shader vertex|fragment|geometry|compute` line.
+enum class ShaderStage
+{
+	Vertex = 0,
+	Fragment,
+	Geometry,
+	Compute,
+	Count
+};
+
+struct ShaderProgramSource
+{
+	//	Indexed by ShaderStage; empty for the stages the file doesn't have.
+	std::string Sources[(int)ShaderStage::Count];
+	//	The files the source string numbers of the #line directives refer to; the .shader file itself is 0.
+	std::vector<std::string> Files;
+
+	inline bool HasStage(ShaderStage stage) const { return !Sources[(int)stage].empty(); }
+};
+
+/**
+*	Splits a .shader file into its stages in one pass over the whole file, instead of a getline and a stringstream
+*	per line. On top of the `#shader` markers it understands:
+*		-	`#include "file"`, relative to the file including it; a file is only included once per stage, and every
+*			file read is kept in a cache, so the shaders sharing an include read it from disk (or the AssetPack) once,
+*		-	the defines it's given, each "NAME" or "NAME=VALUE", put at the top of every stage (after its #version),
+*		-	`#line` directives wherever a line was added or removed, so the drivers' error messages point at the line
+*			of the file it's in; MapLog() then puts the file names in place of their numbers.
+*
+*	The file cache is never invalidated on its own, ClearCache() drops it; it's only used from the render thread.
+*/
+class ShaderPreprocessor
+{
+public:
+	struct Stats
+	{
+		unsigned int Shaders = 0;
+		unsigned int FilesRead = 0;
+		unsigned int CacheHits = 0;
+		double Time = 0.0;
+	};
+
+	explicit ShaderPreprocessor(const std::vector<std::string>& defines = {});
+
+	//	False if `filePath` couldn't be read; a missing include only prints an error.
+	bool Process(const std::string& filePath, ShaderProgramSource& source);
+
+	//	Replaces the source string numbers at the start of the lines of a compile log with the names in `files`.
+	static std::string MapLog(const std::string& log, const std::vector<std::string>& files);
+
+	//	From the cache, the current AssetPack if it has the file, or the disk.
+	static const std::string* ReadFile(const std::string& filePath);
+	static void ClearCache();
+	static const Stats& GetStats();
+
+	static const char* GetStageName(ShaderStage stage);
+	static unsigned int GetGLStage(ShaderStage stage);
+
+private:
+	void ProcessFile(const std::string& filePath, const std::string& contents, int fileIndex, int depth);
+	void Emit(const char* begin, const char* end, int line, int fileIndex);
+	void AddLineDirective(int line, int fileIndex);
+	int GetFileIndex(const std::string& filePath);
+
+private:
+	std::string m_Defines;
+	ShaderProgramSource* m_Source;
+	//	-1 before the first #shader line.
+	int m_Stage;
+	bool m_Started[(int)ShaderStage::Count];
+	//	Where each stage's next line is if nothing was left out, to know when it needs a #line.
+	int m_NextLine[(int)ShaderStage::Count];
+	int m_NextFile[(int)ShaderStage::Count];
+	//	The files each stage included already.
+	std::vector<std::string> m_Included[(int)ShaderStage::Count];
+};
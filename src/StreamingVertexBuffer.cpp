@@ -0,0 +1,154 @@
+#include "StreamingVertexBuffer.h"
+
+#include "Renderer.h"
+#include "GLStateCache.h"
+
+#include <chrono>
+
+
+StreamingVertexBuffer::StreamingVertexBuffer(unsigned int vertexSize, unsigned int verticesPerRegion, unsigned int regionCount)
+    : m_RendererID(0), m_VertexSize(vertexSize), m_VerticesPerRegion(verticesPerRegion), m_RegionCount(regionCount),
+    m_Persistent(false), m_MappedData(nullptr), m_CurrentRegion(0), m_Head(0)
+{
+    ASSERT(regionCount > 0);
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+
+    //  Buffer storage is core from 4.4, but most 3.3 drivers expose it as an extension too.
+    m_Persistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+
+    if (m_Persistent)
+    {
+        GLsizeiptr size = (GLsizeiptr)m_VertexSize * m_VerticesPerRegion * m_RegionCount;
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        //  Immutable storage: the size and flags can't change, which is what allows it to stay mapped.
+        GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+        GLCall(m_MappedData = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        ASSERT(m_MappedData);
+
+        m_Fences.resize(m_RegionCount, nullptr);
+    }
+    else
+    {
+        //  Only one region is needed; orphaning gives the driver the chance to rename the buffer instead.
+        m_RegionCount = 1;
+        m_Staging.resize((size_t)m_VertexSize * m_VerticesPerRegion);
+        GLCall(glBufferData(GL_ARRAY_BUFFER, m_Staging.size(), nullptr, GL_STREAM_DRAW));
+    }
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    if (m_MappedData)
+    {
+        GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+        GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+    }
+
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void* StreamingVertexBuffer::Map(unsigned int maxVertexCount)
+{
+    ASSERT(maxVertexCount <= m_VerticesPerRegion);
+
+    if (!m_Persistent)
+        return m_Staging.data();
+
+    if (m_Head + maxVertexCount > m_VerticesPerRegion)
+        NextRegion();
+
+    //  Starting on a region: make sure the GPU finished the draws from the last time round.
+    if (m_Head == 0)
+        WaitForRegion(m_CurrentRegion);
+
+    unsigned int first = m_CurrentRegion * m_VerticesPerRegion + m_Head;
+    return m_MappedData + (size_t)first * m_VertexSize;
+}
+
+unsigned int StreamingVertexBuffer::Unmap(unsigned int vertexCount)
+{
+    ASSERT(m_Head + vertexCount <= m_VerticesPerRegion);
+    m_Stats.BytesWritten += (unsigned long long)vertexCount * m_VertexSize;
+
+    if (!m_Persistent)
+    {
+        if (vertexCount == 0)
+            return 0;
+
+        GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+        GLCall(glBufferData(GL_ARRAY_BUFFER, m_Staging.size(), nullptr, GL_STREAM_DRAW));
+        GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)vertexCount * m_VertexSize, m_Staging.data()));
+        m_Stats.Orphans++;
+        return 0;
+    }
+
+    //  The mapping is coherent, so the writes are already visible to draws issued after this.
+    unsigned int first = m_CurrentRegion * m_VerticesPerRegion + m_Head;
+    m_Head += vertexCount;
+    return first;
+}
+
+void StreamingVertexBuffer::Fence()
+{
+    if (m_Persistent && m_Head > 0)
+        NextRegion();
+}
+
+void StreamingVertexBuffer::NextRegion()
+{
+    GLsync& fence = m_Fences[m_CurrentRegion];
+    if (fence)
+        glDeleteSync(fence);
+    //  Signalled once the GPU has executed every command issued before it -- i.e. all the draws that read this region.
+    GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+    m_CurrentRegion = (m_CurrentRegion + 1) % m_RegionCount;
+    m_Head = 0;
+}
+
+void StreamingVertexBuffer::WaitForRegion(unsigned int region)
+{
+    GLsync& fence = m_Fences[region];
+    if (!fence)
+        return;
+
+    //  Checks without waiting first; most of the time the fence has long been signalled.
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        //  Flush so the fence actually gets to the GPU, then wait in 1ms steps.
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        m_Stats.FenceWaitTime += std::chrono::duration<double, std::milli>(end - start).count();
+        m_Stats.FenceWaits++;
+    }
+    ASSERT(result != GL_WAIT_FAILED);
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamingVertexBuffer::Bind() const
+{
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void StreamingVertexBuffer::Unbind() const
+{
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <GL/glew.h>
+
+/**
+*	A Vertex Buffer for data that is rewritten every frame.
+*
+*	With a normal VertexBuffer, every glBufferSubData on data the GPU may still be reading makes the driver
+*	either stall until the GPU is done with it or make a hidden copy.
+*	This instead allocates the buffer once with glBufferStorage and keeps it mapped for its whole life
+*	(GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT), so vertices are written straight into memory the GPU reads.
+*	To not overwrite vertices the GPU hasn't drawn yet, the buffer is split into `regionCount` regions
+*	that are used one after the other (a ring). When the CPU is done with a region, a fence (glFenceSync) is put
+*	after the draws that use it, and the CPU only waits on that fence when it comes back round to that region --
+*	normally a couple of frames later, by when the GPU is long done with it.
+*
+*	Everything is measured in vertices, not bytes, so a write always starts on a whole vertex and
+*	the value returned by Unmap() can be passed straight to glDrawElementsBaseVertex.
+*
+*	When the context has no ARB_buffer_storage, it falls back to "orphaning": the writes go to a CPU array and
+*	Unmap() re-allocates the buffer with glBufferData(nullptr) before uploading, so the driver can hand out
+*	fresh memory instead of waiting on the old one.
+*/
+class StreamingVertexBuffer
+{
+public:
+	struct Stats
+	{
+		unsigned long long BytesWritten = 0;
+		//	How long the CPU was blocked waiting on fences, in milliseconds, and how many times it had to.
+		double FenceWaitTime = 0.0;
+		unsigned int FenceWaits = 0;
+		//	Only counts in the fallback path.
+		unsigned int Orphans = 0;
+	};
+
+	StreamingVertexBuffer(unsigned int vertexSize, unsigned int verticesPerRegion, unsigned int regionCount = 3);
+	~StreamingVertexBuffer();
+
+	/**
+	*	Returns where to write up to `maxVertexCount` vertices. If they don't fit in what is left of the current
+	*	region, the current region is fenced and the next one is used, waiting on it first if the GPU may still be using it.
+	*	Must be followed by Unmap() before the vertices are drawn.
+	*/
+	void* Map(unsigned int maxVertexCount);
+	//	Finishes a write of `vertexCount` vertices and returns the index of the first one in the buffer (the base vertex).
+	unsigned int Unmap(unsigned int vertexCount);
+	//	Call once the draws for this frame have been issued; fences the current region and moves on to the next one.
+	void Fence();
+
+	void Bind() const;
+	void Unbind() const;
+
+	inline bool IsPersistent() const { return m_Persistent; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline const Stats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Stats(); }
+
+private:
+	void NextRegion();
+	void WaitForRegion(unsigned int region);
+
+private:
+	unsigned int m_RendererID;
+	unsigned int m_VertexSize;
+	unsigned int m_VerticesPerRegion;
+	unsigned int m_RegionCount;
+
+	bool m_Persistent;
+	unsigned char* m_MappedData;
+	std::vector<GLsync> m_Fences;
+	unsigned int m_CurrentRegion;
+	//	Next free vertex in the current region.
+	unsigned int m_Head;
+
+	//	Fallback path only.
+	std::vector<unsigned char> m_Staging;
+
+	Stats m_Stats;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+/**
+*	A rectangle of a texture, e.g. one image packed into a TextureAtlas.
+*	Renderer2D::DrawQuad() takes one in place of a Texture and maps the quad onto just that rectangle,
+*	so sprites from the same atlas page all share one texture slot.
+*/
+class SubTexture
+{
+public:
+	SubTexture()
+		: m_TextureID(0), m_Min(0.0f), m_Max(1.0f), m_Width(0), m_Height(0) {}
+	SubTexture(unsigned int textureID, const glm::vec2& min, const glm::vec2& max, int width, int height)
+		: m_TextureID(textureID), m_Min(min), m_Max(max), m_Width(width), m_Height(height) {}
+
+	inline unsigned int GetTextureID() const { return m_TextureID; }
+	//	The bottom left and top right texture coordinates of the rectangle.
+	inline const glm::vec2& GetMin() const { return m_Min; }
+	inline const glm::vec2& GetMax() const { return m_Max; }
+	//	The size of the rectangle in pixels.
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+
+private:
+	unsigned int m_TextureID;
+	glm::vec2 m_Min, m_Max;
+	int m_Width, m_Height;
+};
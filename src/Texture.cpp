@@ -1,10 +1,46 @@
 #include "Texture.h"
 
+#include "GLStateCache.h"
+#include "BindlessTextures.h"
+#include "TextureStreamer.h"
+#include "TextureCooker.h"
+#include "AssetPack.h"
+#include "Instrumentor.h"
 #include "stb_image/stb_image.h"
 
-Texture::Texture(const std::string& path)
-	: m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
+#include <algorithm>
+#include <iostream>
+
+Texture::Texture(const std::string& path, TextureLoad load)
+	: m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0), m_Streamer(nullptr), m_Size(0)
 {
+	PROFILE_FUNCTION();
+
+	//	A pack has every image cooked already; its levels are uploaded straight from the mapping.
+	AssetPack* pack = AssetPack::Get();
+	if (pack && pack->Contains(path))
+	{
+		CookedTextureView cooked;
+		AssetPack::Data data;
+		if (!pack->LoadTexture(path, cooked, data))
+			std::cout << "Couldn't load the texture " << path << " from " << pack->GetPath() << '\n';
+		Upload(cooked);
+		return;
+	}
+
+	if (TextureCooker::IsCookedPath(path))
+	{
+		//	Already in the format the GPU samples, with its mipmaps; reading the file is all the work.
+		CookedTexture cooked;
+		if (!TextureCooker::Read(path, cooked))
+			std::cout << "Couldn't read the cooked texture " << path << '\n';
+		Upload(cooked.GetView());
+		return;
+	}
+
+	if (load == TextureLoad::Async)
+		m_Streamer = TextureStreamer::Get();
+
 	/**
 	*	This flips the texture vertically because OpenGL expects texture pixles to start at
 	*	the bottom left at (0, 0) for OpenGL not top left.
@@ -23,9 +59,23 @@ Texture::Texture(const std::string& path)
 
 	//	Now the Texture data is inside this local buffer
 	//	For the last parameter, you could add: STBI_rgb or 4
-	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	if (m_Streamer)
+	{
+		//	A grey 1x1 stands in until the streamer has the real pixels; it's decoded on the JobSystem instead.
+		static unsigned char placeholder[4] = { 128, 128, 128, 255 };
+		m_LocalBuffer = placeholder;
+		m_Width = 1;
+		m_Height = 1;
+		m_BPP = 4;
+	}
+	else
+	{
+		PROFILE_SCOPE("stbi_load");
+		m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	}
+	m_Size = (size_t)m_Width * m_Height * 4;
 	GLCall(glGenTextures(1, &m_RendererID));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D, m_RendererID);
 
 	//	Now configure settings for the Texture that's just being generated:
 
@@ -68,21 +118,104 @@ Texture::Texture(const std::string& path)
 	*/
 	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
 	//	Unbind the texture
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
 
 	/**
 	*	Now, at times rather than freeing this data, one may want to leave it on the CPU
 	*	in case one wants to sample it, for example.
 	*/
-	if (m_LocalBuffer)
+	if (m_Streamer)
+	{
+		//	The streamer re-specifies it at its real size, which a bindless handle would forbid.
+		BindlessTextures::SetStreaming(m_RendererID, true);
+		m_Streamer->Load(*this, path);
+	}
+	else if (m_LocalBuffer)
 		stbi_image_free(m_LocalBuffer);
+	m_LocalBuffer = nullptr;
+}
+
+Texture::Texture(const CookedTexture& texture, const std::string& path)
+	: m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0), m_Streamer(nullptr), m_Size(0)
+{
+	PROFILE_FUNCTION();
+
+	Upload(texture.GetView());
 }
 
 Texture::~Texture()
 {
+	if (m_Streamer)
+	{
+		m_Streamer->Cancel(*this);
+		BindlessTextures::SetStreaming(m_RendererID, false);
+	}
+	BindlessTextures::Release(m_RendererID);
+	GLStateCache::Get().OnDeleteTexture(m_RendererID);
 	GLCall(glDeleteTextures(1, &m_RendererID));
 }
 
+void Texture::OnStreamed(int width, int height)
+{
+	m_Width = width;
+	m_Height = height;
+	m_BPP = 4;
+	m_Size = (size_t)width * height * 4;
+	m_Streamer = nullptr;
+	BindlessTextures::SetStreaming(m_RendererID, false);
+}
+
+void Texture::Upload(const CookedTextureView& texture)
+{
+	const CookedTextureView* source = &texture;
+	CookedTextureView placeholder;
+	if (texture.Levels.empty() || !TextureCooker::IsSupported(texture.Format))
+	{
+		if (!texture.Levels.empty())
+			std::cout << "This GPU can't sample " << TextureCooker::GetFormatName(texture.Format) << " textures: " << m_FilePath << '\n';
+		static const unsigned char grey[4] = { 128, 128, 128, 255 };
+		placeholder.Width = 1;
+		placeholder.Height = 1;
+		placeholder.Levels.push_back(grey);
+		source = &placeholder;
+	}
+
+	m_Width = source->Width;
+	m_Height = source->Height;
+	m_BPP = 4;
+	m_Size = 0;
+
+	const int levelCount = (int)source->Levels.size();
+	GLCall(glGenTextures(1, &m_RendererID));
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D, m_RendererID);
+
+	//	Trilinear filtering between the cooked levels, so minified textures don't alias;
+	//	the max level keeps the texture complete when the chain was cooked without mips.
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+
+	const unsigned int internalFormat = TextureCooker::GetGLInternalFormat(source->Format);
+	for (int level = 0; level < levelCount; level++)
+	{
+		const unsigned char* data = source->Levels[level];
+		int width = std::max(1, m_Width >> level), height = std::max(1, m_Height >> level);
+		size_t size = TextureCooker::GetLevelSize(source->Format, width, height);
+		m_Size += size;
+		if (source->Format == TextureFormat::RGBA8)
+		{
+			GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+		}
+		else
+		{
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, (GLsizei)size, data));
+		}
+	}
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+}
+
 void Texture::Bind(unsigned int slot) const
 {
 	/**
@@ -99,11 +232,11 @@ void Texture::Bind(unsigned int slot) const
 	*	They are integers, hence the slots can be added.
 	*/
 
-	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLStateCache::Get().ActiveTexture(slot);
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D, m_RendererID);
 }
 
 void Texture::Unbind() const
 {
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
 }
@@ -3,6 +3,19 @@
 
 #include "Renderer.h"
 
+class TextureStreamer;
+struct CookedTexture;
+struct CookedTextureView;
+
+enum class TextureLoad
+{
+	//	The file is decoded and uploaded before the constructor returns.
+	Sync,
+	//	The texture starts as a 1x1 placeholder and the current TextureStreamer loads it in the background;
+	//	the same as Sync if there is no streamer.
+	Async
+};
+
 class Texture
 {
 private:
@@ -11,9 +24,19 @@ private:
 	unsigned char* m_LocalBuffer;
 	//	BPP - bits per pixel
 	int m_Width, m_Height, m_BPP;
+	//	The streamer still loading this texture, or null.
+	TextureStreamer* m_Streamer;
+	//	The bytes the texture takes on the GPU, with all its levels.
+	size_t m_Size;
 
 public:
-	Texture(const std::string& path);
+	/**
+	*	A path ending in .ktx is a texture made by the TextureCooker: its levels are uploaded as they are,
+	*	without decoding, so it's always loaded Sync. So is any path the current AssetPack has.
+	*/
+	Texture(const std::string& path, TextureLoad load = TextureLoad::Sync);
+	//	Uploads a texture cooked in memory; `path` is only for messages.
+	Texture(const CookedTexture& texture, const std::string& path = "");
 	~Texture();
 
 	/**
@@ -30,4 +53,15 @@ public:
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
 	inline int GetBPP() const { return m_BPP; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline size_t GetSize() const { return m_Size; }
+	//	False while an Async texture still shows its placeholder.
+	inline bool IsLoaded() const { return m_Streamer == nullptr; }
+
+private:
+	friend class TextureStreamer;
+	//	Called by the streamer once the real pixels have been uploaded.
+	void OnStreamed(int width, int height);
+	//	Creates the texture with every level of `texture`, or a grey 1x1 if the GPU can't sample its format.
+	void Upload(const CookedTextureView& texture);
 };
\ No newline at end of file
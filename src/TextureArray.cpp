@@ -0,0 +1,127 @@
+#include "TextureArray.h"
+
+#include "Renderer.h"
+#include "GLStateCache.h"
+#include "Instrumentor.h"
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+//  Bilinear resampling of an RGBA8 image; good enough for putting images of other sizes into a layer.
+static void ResizeImage(const unsigned char* source, int sourceWidth, int sourceHeight, unsigned char* destination, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        float sy = std::max(0.0f, ((float)y + 0.5f) * sourceHeight / height - 0.5f);
+        int y0 = std::min((int)sy, sourceHeight - 1);
+        int y1 = std::min(y0 + 1, sourceHeight - 1);
+        float fy = sy - (float)y0;
+
+        for (int x = 0; x < width; x++)
+        {
+            float sx = std::max(0.0f, ((float)x + 0.5f) * sourceWidth / width - 0.5f);
+            int x0 = std::min((int)sx, sourceWidth - 1);
+            int x1 = std::min(x0 + 1, sourceWidth - 1);
+            float fx = sx - (float)x0;
+
+            for (int c = 0; c < 4; c++)
+            {
+                float top = source[(y0 * sourceWidth + x0) * 4 + c] * (1.0f - fx) + source[(y0 * sourceWidth + x1) * 4 + c] * fx;
+                float bottom = source[(y1 * sourceWidth + x0) * 4 + c] * (1.0f - fx) + source[(y1 * sourceWidth + x1) * 4 + c] * fx;
+                destination[(y * width + x) * 4 + c] = (unsigned char)(top * (1.0f - fy) + bottom * fy + 0.5f);
+            }
+        }
+    }
+}
+
+TextureArray::TextureArray(int width, int height, int layers, int mipLevels)
+    : m_RendererID(0), m_Width(width), m_Height(height), m_Layers(layers), m_MipLevels(mipLevels)
+{
+    ASSERT(width > 0 && height > 0 && layers > 0);
+
+    if (m_MipLevels <= 0)
+        m_MipLevels = 1 + (int)std::floor(std::log2((float)std::max(width, height)));
+
+    GLCall(glGenTextures(1, &m_RendererID));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, m_MipLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_MipLevels - 1));
+
+    //  Texture storage is core from 4.2; most 3.3 drivers have the extension.
+    if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage)
+    {
+        GLCall(glTexStorage3D(GL_TEXTURE_2D_ARRAY, m_MipLevels, GL_RGBA8, width, height, layers));
+    }
+    else
+    {
+        for (int level = 0; level < m_MipLevels; level++)
+        {
+            GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, width >> level), std::max(1, height >> level), layers,
+                0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        }
+    }
+
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+TextureArray::~TextureArray()
+{
+    GLStateCache::Get().OnDeleteTexture(m_RendererID);
+    GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+void TextureArray::SetLayer(int layer, const unsigned char* pixels)
+{
+    ASSERT(layer >= 0 && layer < m_Layers);
+
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID);
+    GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_Width, m_Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+bool TextureArray::LoadLayer(int layer, const std::string& path)
+{
+    PROFILE_FUNCTION();
+
+    int width = 0, height = 0, bpp = 0;
+    stbi_set_flip_vertically_on_load(1);
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+    if (!pixels)
+        return false;
+
+    if (width == m_Width && height == m_Height)
+        SetLayer(layer, pixels);
+    else
+    {
+        std::vector<unsigned char> resized((size_t)m_Width * m_Height * 4);
+        ResizeImage(pixels, width, height, resized.data(), m_Width, m_Height);
+        SetLayer(layer, resized.data());
+    }
+
+    stbi_image_free(pixels);
+    return true;
+}
+
+void TextureArray::GenerateMipmaps()
+{
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID);
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::Bind(unsigned int slot) const
+{
+    GLStateCache::Get().BindTextureUnit(slot, m_RendererID, GL_TEXTURE_2D_ARRAY);
+}
+
+void TextureArray::Unbind() const
+{
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+/**
+*	Many images of the same size stored as the layers of one GL_TEXTURE_2D_ARRAY.
+*
+*	A batch that samples with `texture(u_Textures, vec3(uv, layer))` needs only this one texture bound,
+*	so it isn't limited to GL_MAX_TEXTURE_IMAGE_UNITS different textures like a sampler2D array is,
+*	and the layer can differ between fragments without the lookup needing a dynamically uniform index.
+*
+*	The storage is allocated once with glTexStorage3D (immutable; glTexImage3D on drivers without
+*	ARB_texture_storage); layers are filled in afterwards with SetLayer() or LoadLayer().
+*/
+class TextureArray
+{
+public:
+	//	`mipLevels` of 0 makes the full chain down to 1x1; fill the layers, then call GenerateMipmaps().
+	TextureArray(int width, int height, int layers, int mipLevels = 1);
+	~TextureArray();
+
+	TextureArray(const TextureArray&) = delete;
+	TextureArray& operator=(const TextureArray&) = delete;
+
+	//	`pixels` is width * height RGBA8 pixels, bottom row first.
+	void SetLayer(int layer, const unsigned char* pixels);
+	//	Decodes an image into a layer, resizing it to the size of the array if it differs; false if it can't be loaded.
+	bool LoadLayer(int layer, const std::string& path);
+	void GenerateMipmaps();
+
+	void Bind(unsigned int slot = 0) const;
+	void Unbind() const;
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline int GetLayerCount() const { return m_Layers; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
+private:
+	unsigned int m_RendererID;
+	int m_Width, m_Height, m_Layers;
+	int m_MipLevels;
+};
@@ -0,0 +1,167 @@
+#include "TextureAtlas.h"
+
+#include "Renderer.h"
+#include "GLStateCache.h"
+#include "BindlessTextures.h"
+#include "JobSystem.h"
+#include "Instrumentor.h"
+#include "stb_image/stb_image.h"
+
+//  ImGui compiles its own static copy in imgui_draw.cpp, so this one is static as well.
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+
+namespace
+{
+    struct AtlasImage
+    {
+        std::string Path;
+        unsigned char* Pixels = nullptr;
+        int Width = 0, Height = 0;
+    };
+}
+
+TextureAtlas::TextureAtlas(const std::vector<std::string>& paths, int pageSize, int padding)
+    : m_PageSize(pageSize), m_Padding(padding), m_Occupancy(0.0f)
+{
+    PROFILE_FUNCTION();
+
+    //  Decoding is by far the slowest part, and every image is independent.
+    std::vector<AtlasImage> images(paths.size());
+    JobSystem::Get().ParallelFor((unsigned int)paths.size(), 1, [&images, &paths](unsigned int begin, unsigned int end)
+    {
+        stbi_set_flip_vertically_on_load_thread(1);
+        for (unsigned int i = begin; i < end; i++)
+        {
+            PROFILE_SCOPE("stbi_load");
+            int bpp = 0;
+            images[i].Path = paths[i];
+            images[i].Pixels = stbi_load(paths[i].c_str(), &images[i].Width, &images[i].Height, &bpp, 4);
+        }
+    });
+
+    std::vector<stbrp_rect> rects;
+    for (int i = 0; i < (int)images.size(); i++)
+    {
+        const AtlasImage& image = images[i];
+        if (!image.Pixels)
+        {
+            std::cout << "[TextureAtlas] Failed to load " << image.Path << '\n';
+            continue;
+        }
+        if (image.Width + 2 * padding > pageSize || image.Height + 2 * padding > pageSize)
+        {
+            std::cout << "[TextureAtlas] " << image.Path << " (" << image.Width << "x" << image.Height << ") doesn't fit in a "
+                << pageSize << "x" << pageSize << " page\n";
+            continue;
+        }
+
+        stbrp_rect rect = {};
+        rect.id = i;
+        rect.w = image.Width + 2 * padding;
+        rect.h = image.Height + 2 * padding;
+        rects.push_back(rect);
+    }
+
+    std::vector<stbrp_node> nodes(pageSize);
+    std::vector<unsigned char> pixels;
+    unsigned long long usedArea = 0;
+
+    //  Each page takes whatever it can of what is left, until nothing is left.
+    while (!rects.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize, pageSize, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&context, rects.data(), (int)rects.size());
+
+        pixels.assign((size_t)pageSize * pageSize * 4, 0);
+        std::vector<stbrp_rect> packed, left;
+
+        for (const stbrp_rect& rect : rects)
+        {
+            if (!rect.was_packed)
+            {
+                left.push_back(rect);
+                continue;
+            }
+
+            const AtlasImage& image = images[rect.id];
+            //  Every row of the padded rectangle: the image row, clamped at the top and bottom for the bleed.
+            for (int y = 0; y < rect.h; y++)
+            {
+                int sourceY = std::min(std::max(y - padding, 0), image.Height - 1);
+                const unsigned char* source = image.Pixels + (size_t)sourceY * image.Width * 4;
+                unsigned char* destination = pixels.data() + ((size_t)(rect.y + y) * pageSize + rect.x) * 4;
+
+                for (int x = 0; x < padding; x++)
+                    std::memcpy(destination + x * 4, source, 4);
+                std::memcpy(destination + padding * 4, source, (size_t)image.Width * 4);
+                for (int x = padding + image.Width; x < rect.w; x++)
+                    std::memcpy(destination + x * 4, source + (image.Width - 1) * 4, 4);
+            }
+            usedArea += (unsigned long long)image.Width * image.Height;
+            packed.push_back(rect);
+        }
+
+        //  Nothing fit into an empty page; the size check above should make this impossible, but it must not loop forever.
+        if (packed.empty())
+            break;
+        unsigned int page = CreatePage(pixels);
+        for (const stbrp_rect& rect : packed)
+        {
+            const AtlasImage& image = images[rect.id];
+            glm::vec2 min((float)(rect.x + padding) / pageSize, (float)(rect.y + padding) / pageSize);
+            glm::vec2 max((float)(rect.x + padding + image.Width) / pageSize, (float)(rect.y + padding + image.Height) / pageSize);
+            m_SubTextures[image.Path] = SubTexture(page, min, max, image.Width, image.Height);
+        }
+        rects.swap(left);
+    }
+
+    for (AtlasImage& image : images)
+    {
+        if (image.Pixels)
+            stbi_image_free(image.Pixels);
+    }
+
+    if (!m_Pages.empty())
+        m_Occupancy = (float)((double)usedArea / ((double)pageSize * pageSize * m_Pages.size()));
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (unsigned int page : m_Pages)
+    {
+        BindlessTextures::Release(page);
+        GLStateCache::Get().OnDeleteTexture(page);
+    }
+    GLCall(glDeleteTextures((int)m_Pages.size(), m_Pages.data()));
+}
+
+const SubTexture& TextureAtlas::Get(const std::string& path) const
+{
+    auto it = m_SubTextures.find(path);
+    ASSERT(it != m_SubTextures.end());
+    return it->second;
+}
+
+unsigned int TextureAtlas::CreatePage(const std::vector<unsigned char>& pixels)
+{
+    unsigned int page = 0;
+    GLCall(glGenTextures(1, &page));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, page);
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_PageSize, m_PageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+
+    m_Pages.push_back(page);
+    return page;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SubTexture.h"
+
+/**
+*	Packs a set of images into one or a few large textures (pages) when it's made, using the rect packer
+*	that comes with ImGui (imstb_rectpack.h).
+*
+*	Each image becomes a SubTexture: the page it's on and its rectangle of UVs. Any number of different sprites
+*	can then be drawn in one batch, as long as they're on the same page, instead of being limited to the
+*	number of texture slots of the batch shader.
+*
+*	Every image is surrounded by `padding` pixels copied from its own edges (bleed), so linear filtering at the
+*	edge of a rectangle blends with the image itself rather than with its neighbour in the atlas.
+*/
+class TextureAtlas
+{
+public:
+	//	Images that don't fit in one page, or fail to load, are left out with a message.
+	TextureAtlas(const std::vector<std::string>& paths, int pageSize = 2048, int padding = 2);
+	~TextureAtlas();
+
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+	inline bool Contains(const std::string& path) const { return m_SubTextures.find(path) != m_SubTextures.end(); }
+	//	The image by the path it was passed in with; it must be in the atlas.
+	const SubTexture& Get(const std::string& path) const;
+
+	inline unsigned int GetPageCount() const { return (unsigned int)m_Pages.size(); }
+	inline unsigned int GetPageRendererID(unsigned int page) const { return m_Pages[page]; }
+	inline int GetPageSize() const { return m_PageSize; }
+	//	How much of the pages' area is taken by images (without their padding), from 0 to 1.
+	inline float GetOccupancy() const { return m_Occupancy; }
+
+private:
+	unsigned int CreatePage(const std::vector<unsigned char>& pixels);
+
+private:
+	int m_PageSize;
+	int m_Padding;
+	std::vector<unsigned int> m_Pages;
+	std::unordered_map<std::string, SubTexture> m_SubTextures;
+	float m_Occupancy;
+};
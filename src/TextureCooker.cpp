@@ -0,0 +1,725 @@
+#include "TextureCooker.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "JobSystem.h"
+#include "Instrumentor.h"
+#include "stb_image/stb_image.h"
+
+
+//  The 12 bytes every KTX 1.1 file starts with.
+static const unsigned char KtxIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+static const uint32_t KtxEndianness = 0x04030201;
+//  Written so other tools know the first row is the bottom one.
+static const char KtxOrientation[] = "KTXorientation\0S=r,T=u";
+
+//  The weights BC7 interpolates its 16 levels with, out of 64.
+static const int Bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+size_t CookedTexture::GetSize() const
+{
+    size_t size = 0;
+    for (const std::vector<unsigned char>& level : Levels)
+        size += level.size();
+    return size;
+}
+
+CookedTextureView CookedTexture::GetView() const
+{
+    CookedTextureView view;
+    view.Format = Format;
+    view.Width = Width;
+    view.Height = Height;
+    for (const std::vector<unsigned char>& level : Levels)
+        view.Levels.push_back(level.data());
+    return view;
+}
+
+//  Writes the fields of a compressed block from the lowest bit up.
+struct BlockWriter
+{
+    unsigned char* Block;
+    unsigned int Position = 0;
+
+    explicit BlockWriter(unsigned char* block) : Block(block) {}
+
+    void Write(unsigned int value, unsigned int bits)
+    {
+        for (unsigned int bit = 0; bit < bits; bit++, Position++)
+        {
+            if ((value >> bit) & 1)
+                Block[Position >> 3] |= (unsigned char)(1 << (Position & 7));
+        }
+    }
+};
+
+//  The 16 pixels of a block as RGBA; pixels past the edge of the image repeat the last row/column.
+static void ReadBlock(const unsigned char* pixels, int width, int height, int blockX, int blockY, float block[16][4])
+{
+    for (int y = 0; y < 4; y++)
+    {
+        int sy = std::min(blockY * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++)
+        {
+            int sx = std::min(blockX * 4 + x, width - 1);
+            const unsigned char* pixel = &pixels[((size_t)sy * width + sx) * 4];
+            for (int c = 0; c < 4; c++)
+                block[y * 4 + x][c] = (float)pixel[c];
+        }
+    }
+}
+
+/**
+*   The direction the colors of the block spread the most along, i.e. the principal axis of their covariance,
+*   found by power iteration. Only the first `channels` channels are looked at.
+*/
+static void PrincipalAxis(const float block[16][4], int channels, float mean[4], float axis[4])
+{
+    for (int c = 0; c < 4; c++)
+    {
+        mean[c] = 0.0f;
+        for (int i = 0; i < 16; i++)
+            mean[c] += block[i][c];
+        mean[c] /= 16.0f;
+    }
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; i++)
+    {
+        for (int a = 0; a < channels; a++)
+        {
+            for (int b = 0; b < channels; b++)
+                covariance[a][b] += (block[i][a] - mean[a]) * (block[i][b] - mean[b]);
+        }
+    }
+
+    for (int c = 0; c < 4; c++)
+        axis[c] = c < channels ? 1.0f : 0.0f;
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        float next[4] = {};
+        float length = 0.0f;
+        for (int a = 0; a < channels; a++)
+        {
+            for (int b = 0; b < channels; b++)
+                next[a] += covariance[a][b] * axis[b];
+            length = std::max(length, std::fabs(next[a]));
+        }
+        //  All the pixels are the same color; any axis will do.
+        if (length < 1e-6f)
+            break;
+        for (int a = 0; a < channels; a++)
+            axis[a] = next[a] / length;
+    }
+}
+
+//  The two pixels of the block furthest apart along its principal axis.
+static void FitEndpoints(const float block[16][4], int channels, float low[4], float high[4])
+{
+    float mean[4], axis[4];
+    PrincipalAxis(block, channels, mean, axis);
+
+    float minProjection = 1e30f, maxProjection = -1e30f;
+    int minPixel = 0, maxPixel = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        float projection = 0.0f;
+        for (int c = 0; c < channels; c++)
+            projection += (block[i][c] - mean[c]) * axis[c];
+        if (projection < minProjection) { minProjection = projection; minPixel = i; }
+        if (projection > maxProjection) { maxProjection = projection; maxPixel = i; }
+    }
+    for (int c = 0; c < 4; c++)
+    {
+        low[c] = block[minPixel][c];
+        high[c] = block[maxPixel][c];
+    }
+}
+
+static uint16_t PackRGB565(const float color[4])
+{
+    unsigned int r = (unsigned int)std::min(31.0f, std::max(0.0f, color[0] * 31.0f / 255.0f + 0.5f));
+    unsigned int g = (unsigned int)std::min(63.0f, std::max(0.0f, color[1] * 63.0f / 255.0f + 0.5f));
+    unsigned int b = (unsigned int)std::min(31.0f, std::max(0.0f, color[2] * 31.0f / 255.0f + 0.5f));
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(uint16_t packed, int color[3])
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+//  8 bytes: two RGB565 endpoints and a 2 bit index per pixel, always in the 4 color (opaque) mode.
+static void EncodeBC1(const float block[16][4], unsigned char* out)
+{
+    float low[4], high[4];
+    FitEndpoints(block, 3, low, high);
+
+    uint16_t color0 = PackRGB565(high), color1 = PackRGB565(low);
+    //  color0 > color1 is what selects the 4 color mode.
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    uint32_t indices = 0;
+    if (color0 != color1)
+    {
+        int palette[4][3];
+        UnpackRGB565(color0, palette[0]);
+        UnpackRGB565(color1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            float bestError = 1e30f;
+            uint32_t best = 0;
+            for (uint32_t p = 0; p < 4; p++)
+            {
+                float error = 0.0f;
+                for (int c = 0; c < 3; c++)
+                {
+                    float d = block[i][c] - (float)palette[p][c];
+                    error += d * d;
+                }
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= best << (i * 2);
+        }
+    }
+
+    out[0] = (unsigned char)(color0 & 0xFF);
+    out[1] = (unsigned char)(color0 >> 8);
+    out[2] = (unsigned char)(color1 & 0xFF);
+    out[3] = (unsigned char)(color1 >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+//  8 bytes: the alpha of BC3, two 8 bit endpoints with 6 values between them and a 3 bit index per pixel.
+static void EncodeBC3Alpha(const float block[16][4], unsigned char* out)
+{
+    int alpha0 = 0, alpha1 = 255;
+    for (int i = 0; i < 16; i++)
+    {
+        alpha0 = std::max(alpha0, (int)block[i][3]);
+        alpha1 = std::min(alpha1, (int)block[i][3]);
+    }
+
+    BlockWriter writer(out);
+    writer.Write((unsigned int)alpha0, 8);
+    writer.Write((unsigned int)alpha1, 8);
+    if (alpha0 == alpha1)
+    {
+        writer.Write(0, 48);
+        return;
+    }
+
+    //  alpha0 > alpha1 selects the 8 value mode.
+    int palette[8] = { alpha0, alpha1 };
+    for (int i = 1; i < 7; i++)
+        palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+
+    for (int i = 0; i < 16; i++)
+    {
+        int bestError = 256;
+        unsigned int best = 0;
+        for (unsigned int p = 0; p < 8; p++)
+        {
+            int error = std::abs((int)block[i][3] - palette[p]);
+            if (error < bestError) { bestError = error; best = p; }
+        }
+        writer.Write(best, 3);
+    }
+}
+
+struct Bc7Endpoints
+{
+    //  7 bits per channel; the p-bit is the 8th (lowest) bit of every channel of its endpoint.
+    int Color[2][4];
+    int PBit[2];
+
+    int Value(int endpoint, int channel) const { return (Color[endpoint][channel] << 1) | PBit[endpoint]; }
+};
+
+//  Picks the 7 bit channels and the p-bit that are closest to `color`.
+static void QuantizeBc7Endpoint(const float color[4], Bc7Endpoints& endpoints, int endpoint)
+{
+    float bestError = 1e30f;
+    for (int pBit = 0; pBit < 2; pBit++)
+    {
+        int quantized[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++)
+        {
+            quantized[c] = (int)std::min(127.0f, std::max(0.0f, std::floor((color[c] - pBit) / 2.0f + 0.5f)));
+            float d = (float)((quantized[c] << 1) | pBit) - color[c];
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            endpoints.PBit[endpoint] = pBit;
+            std::memcpy(endpoints.Color[endpoint], quantized, sizeof(quantized));
+        }
+    }
+}
+
+//  Gives every pixel the nearest of the 16 levels; returns the total squared error.
+static float SelectBc7Indices(const float block[16][4], const Bc7Endpoints& endpoints, int indices[16])
+{
+    float palette[16][4];
+    for (int p = 0; p < 16; p++)
+    {
+        for (int c = 0; c < 4; c++)
+            palette[p][c] = (float)(((64 - Bc7Weights[p]) * endpoints.Value(0, c) + Bc7Weights[p] * endpoints.Value(1, c) + 32) >> 6);
+    }
+
+    float total = 0.0f;
+    for (int i = 0; i < 16; i++)
+    {
+        float bestError = 1e30f;
+        for (int p = 0; p < 16; p++)
+        {
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++)
+            {
+                float d = block[i][c] - palette[p][c];
+                error += d * d;
+            }
+            if (error < bestError) { bestError = error; indices[i] = p; }
+        }
+        total += bestError;
+    }
+    return total;
+}
+
+/**
+*   The endpoints that fit the pixels best for the levels they were given (least squares), so the levels
+*   move to where the pixels are instead of staying at the two most extreme pixels. False if every pixel
+*   got the same weight, where there's nothing to solve.
+*/
+static bool RefineBc7Endpoints(const float block[16][4], const int indices[16], float low[4], float high[4])
+{
+    float a = 0.0f, b = 0.0f, c = 0.0f;
+    float x0[4] = {}, x1[4] = {};
+    for (int i = 0; i < 16; i++)
+    {
+        float t = Bc7Weights[indices[i]] / 64.0f;
+        a += (1.0f - t) * (1.0f - t);
+        b += (1.0f - t) * t;
+        c += t * t;
+        for (int ch = 0; ch < 4; ch++)
+        {
+            x0[ch] += (1.0f - t) * block[i][ch];
+            x1[ch] += t * block[i][ch];
+        }
+    }
+
+    float determinant = a * c - b * b;
+    if (std::fabs(determinant) < 1e-6f)
+        return false;
+    for (int ch = 0; ch < 4; ch++)
+    {
+        low[ch] = std::min(255.0f, std::max(0.0f, (c * x0[ch] - b * x1[ch]) / determinant));
+        high[ch] = std::min(255.0f, std::max(0.0f, (a * x1[ch] - b * x0[ch]) / determinant));
+    }
+    return true;
+}
+
+//  16 bytes: BC7 mode 6, one subset with two RGBA endpoints of 7 bits + a p-bit each and a 4 bit index per pixel.
+static void EncodeBC7(const float block[16][4], unsigned char* out)
+{
+    float low[4], high[4];
+    FitEndpoints(block, 4, low, high);
+
+    Bc7Endpoints endpoints;
+    QuantizeBc7Endpoint(low, endpoints, 0);
+    QuantizeBc7Endpoint(high, endpoints, 1);
+    int indices[16];
+    float error = SelectBc7Indices(block, endpoints, indices);
+
+    if (RefineBc7Endpoints(block, indices, low, high))
+    {
+        Bc7Endpoints refined;
+        QuantizeBc7Endpoint(low, refined, 0);
+        QuantizeBc7Endpoint(high, refined, 1);
+        int refinedIndices[16];
+        if (SelectBc7Indices(block, refined, refinedIndices) < error)
+        {
+            endpoints = refined;
+            std::memcpy(indices, refinedIndices, sizeof(indices));
+        }
+    }
+
+    //  The first pixel's index is stored without its top bit, so it has to be below 8; swapping the endpoints mirrors the levels.
+    if (indices[0] >= 8)
+    {
+        std::swap(endpoints.Color[0], endpoints.Color[1]);
+        std::swap(endpoints.PBit[0], endpoints.PBit[1]);
+        for (int i = 0; i < 16; i++)
+            indices[i] = 15 - indices[i];
+    }
+
+    std::memset(out, 0, 16);
+    BlockWriter writer(out);
+    //  The mode is the position of the first set bit.
+    writer.Write(1 << 6, 7);
+    for (int c = 0; c < 4; c++)
+    {
+        writer.Write((unsigned int)endpoints.Color[0][c], 7);
+        writer.Write((unsigned int)endpoints.Color[1][c], 7);
+    }
+    writer.Write((unsigned int)endpoints.PBit[0], 1);
+    writer.Write((unsigned int)endpoints.PBit[1], 1);
+    writer.Write((unsigned int)indices[0], 3);
+    for (int i = 1; i < 16; i++)
+        writer.Write((unsigned int)indices[i], 4);
+}
+
+/**
+*   The next smaller level: every pixel is the average of the pixels of `pixels` it covers, which also works
+*   for odd sizes. Colors are weighted by their alpha so that fully transparent pixels (usually black) don't
+*   darken the edges of sprites.
+*/
+static std::vector<unsigned char> Downsample(const std::vector<unsigned char>& pixels, int width, int height, int newWidth, int newHeight)
+{
+    std::vector<unsigned char> result((size_t)newWidth * newHeight * 4);
+    for (int y = 0; y < newHeight; y++)
+    {
+        int y0 = y * height / newHeight, y1 = std::max(y0 + 1, (y + 1) * height / newHeight);
+        for (int x = 0; x < newWidth; x++)
+        {
+            int x0 = x * width / newWidth, x1 = std::max(x0 + 1, (x + 1) * width / newWidth);
+
+            double weighted[3] = {}, color[3] = {}, alpha = 0.0;
+            int count = 0;
+            for (int sy = y0; sy < y1; sy++)
+            {
+                for (int sx = x0; sx < x1; sx++)
+                {
+                    const unsigned char* pixel = &pixels[((size_t)sy * width + sx) * 4];
+                    for (int c = 0; c < 3; c++)
+                    {
+                        weighted[c] += (double)pixel[c] * pixel[3];
+                        color[c] += pixel[c];
+                    }
+                    alpha += pixel[3];
+                    count++;
+                }
+            }
+
+            unsigned char* out = &result[((size_t)y * newWidth + x) * 4];
+            for (int c = 0; c < 3; c++)
+                out[c] = (unsigned char)(alpha > 0.0 ? weighted[c] / alpha + 0.5 : color[c] / count + 0.5);
+            out[3] = (unsigned char)(alpha / count + 0.5);
+        }
+    }
+    return result;
+}
+
+static std::vector<unsigned char> Encode(const std::vector<unsigned char>& pixels, int width, int height, TextureFormat format)
+{
+    if (format == TextureFormat::RGBA8)
+        return pixels;
+
+    const int blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+    const size_t blockSize = format == TextureFormat::BC1 ? 8 : 16;
+    std::vector<unsigned char> result((size_t)blocksWide * blocksHigh * blockSize);
+
+    //  Every block is independent, so a row of blocks is one unit of work.
+    JobSystem::Get().ParallelFor((unsigned int)blocksHigh, 1, [&](unsigned int begin, unsigned int end)
+    {
+        float block[16][4];
+        for (unsigned int blockY = begin; blockY < end; blockY++)
+        {
+            for (int blockX = 0; blockX < blocksWide; blockX++)
+            {
+                ReadBlock(pixels.data(), width, height, blockX, (int)blockY, block);
+                unsigned char* out = &result[((size_t)blockY * blocksWide + blockX) * blockSize];
+                switch (format)
+                {
+                case TextureFormat::BC1:
+                    EncodeBC1(block, out);
+                    break;
+                case TextureFormat::BC3:
+                    EncodeBC3Alpha(block, out);
+                    EncodeBC1(block, out + 8);
+                    break;
+                default:
+                    EncodeBC7(block, out);
+                    break;
+                }
+            }
+        }
+    });
+    return result;
+}
+
+CookedTexture TextureCooker::Cook(const unsigned char* pixels, int width, int height, const Options& options)
+{
+    PROFILE_FUNCTION();
+
+    CookedTexture texture;
+    texture.Format = options.Format;
+    texture.Width = width;
+    texture.Height = height;
+
+    std::vector<unsigned char> level(pixels, pixels + (size_t)width * height * 4);
+    while (true)
+    {
+        texture.Levels.push_back(Encode(level, width, height, options.Format));
+        if (!options.Mipmaps || (width == 1 && height == 1))
+            break;
+
+        int newWidth = std::max(1, width / 2), newHeight = std::max(1, height / 2);
+        level = Downsample(level, width, height, newWidth, newHeight);
+        width = newWidth;
+        height = newHeight;
+    }
+    return texture;
+}
+
+bool TextureCooker::CookFile(const std::string& path, const Options& options, CookedTexture& texture)
+{
+    int width, height, bpp;
+    //  Bottom row first, the same as Texture loads them.
+    stbi_set_flip_vertically_on_load_thread(1);
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+    if (!pixels)
+        return false;
+
+    texture = Cook(pixels, width, height, options);
+    stbi_image_free(pixels);
+    return true;
+}
+
+static void WriteUint32(std::ofstream& file, uint32_t value)
+{
+    file.write((const char*)&value, sizeof(value));
+}
+
+bool TextureCooker::Write(const std::string& path, const CookedTexture& texture)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    bool compressed = texture.Format != TextureFormat::RGBA8;
+    bool opaque = texture.Format == TextureFormat::BC1;
+
+    file.write((const char*)KtxIdentifier, sizeof(KtxIdentifier));
+    WriteUint32(file, KtxEndianness);
+    WriteUint32(file, compressed ? 0 : GL_UNSIGNED_BYTE);               //  glType
+    WriteUint32(file, 1);                                               //  glTypeSize
+    WriteUint32(file, compressed ? 0 : GL_RGBA);                        //  glFormat
+    WriteUint32(file, GetGLInternalFormat(texture.Format));             //  glInternalFormat
+    WriteUint32(file, opaque ? GL_RGB : GL_RGBA);                       //  glBaseInternalFormat
+    WriteUint32(file, (uint32_t)texture.Width);
+    WriteUint32(file, (uint32_t)texture.Height);
+    WriteUint32(file, 0);                                               //  pixelDepth
+    WriteUint32(file, 0);                                               //  numberOfArrayElements
+    WriteUint32(file, 1);                                               //  numberOfFaces
+    WriteUint32(file, (uint32_t)texture.Levels.size());
+
+    //  One key/value pair, padded to 4 bytes.
+    const uint32_t pairSize = (uint32_t)sizeof(KtxOrientation);
+    const uint32_t padding = 3 - (pairSize + 3) % 4;
+    WriteUint32(file, 4 + pairSize + padding);
+    WriteUint32(file, pairSize);
+    file.write(KtxOrientation, pairSize);
+    const char zeros[4] = {};
+    file.write(zeros, padding);
+
+    //  Levels of every format here are a multiple of 4 bytes, so they need no padding.
+    for (const std::vector<unsigned char>& level : texture.Levels)
+    {
+        WriteUint32(file, (uint32_t)level.size());
+        file.write((const char*)level.data(), level.size());
+    }
+    return (bool)file;
+}
+
+bool TextureCooker::Read(const std::string& path, CookedTexture& texture)
+{
+    PROFILE_FUNCTION();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    unsigned char identifier[12];
+    uint32_t header[13];
+    file.read((char*)identifier, sizeof(identifier));
+    file.read((char*)header, sizeof(header));
+    if (!file || std::memcmp(identifier, KtxIdentifier, sizeof(identifier)) != 0 || header[0] != KtxEndianness)
+        return false;
+
+    const uint32_t internalFormat = header[4];
+    TextureFormat formats[] = { TextureFormat::RGBA8, TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+    bool known = false;
+    for (TextureFormat format : formats)
+    {
+        if (GetGLInternalFormat(format) == internalFormat)
+        {
+            texture.Format = format;
+            known = true;
+        }
+    }
+    //  Only 2D textures with no faces or layers.
+    if (!known || header[8] > 1 || header[9] > 0 || header[10] != 1)
+        return false;
+
+    texture.Width = (int)header[6];
+    texture.Height = (int)header[7];
+    const uint32_t levelCount = std::max(1u, header[11]);
+    file.seekg(header[12], std::ios::cur);
+
+    texture.Levels.clear();
+    texture.Levels.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        uint32_t size = 0;
+        file.read((char*)&size, sizeof(size));
+        int width = std::max(1, texture.Width >> level), height = std::max(1, texture.Height >> level);
+        if (!file || size != GetLevelSize(texture.Format, width, height))
+            return false;
+
+        texture.Levels[level].resize(size);
+        file.read((char*)texture.Levels[level].data(), size);
+    }
+    return (bool)file;
+}
+
+std::string TextureCooker::GetCookedPath(const std::string& path)
+{
+    size_t separator = path.find_last_of("/\\");
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+        return path + ".ktx";
+    return path.substr(0, dot) + ".ktx";
+}
+
+bool TextureCooker::IsCookedPath(const std::string& path)
+{
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".ktx") == 0;
+}
+
+const char* TextureCooker::GetFormatName(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1: return "BC1";
+    case TextureFormat::BC3: return "BC3";
+    case TextureFormat::BC7: return "BC7";
+    default:                 return "RGBA8";
+    }
+}
+
+unsigned int TextureCooker::GetGLInternalFormat(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default:                 return GL_RGBA8;
+    }
+}
+
+bool TextureCooker::IsSupported(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+    case TextureFormat::BC3:
+        return GLEW_EXT_texture_compression_s3tc != 0;
+    case TextureFormat::BC7:
+        return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+    default:
+        return true;
+    }
+}
+
+size_t TextureCooker::GetLevelSize(TextureFormat format, int width, int height)
+{
+    if (format == TextureFormat::RGBA8)
+        return (size_t)width * height * 4;
+    size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+    return blocks * (format == TextureFormat::BC1 ? 8 : 16);
+}
+
+bool TextureCooker::ParseArgs(int argc, char** argv, Options& options, std::vector<std::string>& inputs)
+{
+    bool cook = false;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--cook") == 0)
+            cook = true;
+        else if (std::strcmp(argv[i], "--no-mips") == 0)
+            options.Mipmaps = false;
+        else if (std::strcmp(argv[i], "--format") == 0 && hasValue)
+        {
+            const char* name = argv[++i];
+            if (std::strcmp(name, "rgba8") == 0)
+                options.Format = TextureFormat::RGBA8;
+            else if (std::strcmp(name, "bc1") == 0)
+                options.Format = TextureFormat::BC1;
+            else if (std::strcmp(name, "bc3") == 0)
+                options.Format = TextureFormat::BC3;
+            else if (std::strcmp(name, "bc7") == 0)
+                options.Format = TextureFormat::BC7;
+            else
+                std::cout << "Unknown texture format " << name << ", using " << GetFormatName(options.Format) << '\n';
+        }
+        else if (std::strncmp(argv[i], "--", 2) != 0)
+            inputs.push_back(argv[i]);
+    }
+    return cook;
+}
+
+int TextureCooker::Run(const Options& options, const std::vector<std::string>& inputs)
+{
+    int failed = 0;
+    for (const std::string& input : inputs)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        CookedTexture texture;
+        std::string output = GetCookedPath(input);
+        if (!CookFile(input, options, texture))
+        {
+            std::cout << "Couldn't decode " << input << '\n';
+            failed++;
+            continue;
+        }
+        if (!Write(output, texture))
+        {
+            std::cout << "Couldn't write " << output << '\n';
+            failed++;
+            continue;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        size_t uncompressed = (size_t)texture.Width * texture.Height * 4;
+        std::cout << input << " -> " << output << ": " << texture.Width << "x" << texture.Height << ", "
+            << texture.Levels.size() << " levels of " << GetFormatName(texture.Format) << ", "
+            << texture.GetSize() / 1024 << " KB (RGBA8 without mips: " << uncompressed / 1024 << " KB) in " << ms << " ms\n";
+    }
+    return failed;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//	What a cooked texture's levels are stored as.
+enum class TextureFormat
+{
+	//	Uncompressed, 4 bytes per pixel.
+	RGBA8,
+	//	DXT1: 8 bytes per 4x4 block (0.5 byte per pixel), opaque RGB.
+	BC1,
+	//	DXT5: 16 bytes per 4x4 block (1 byte per pixel), BC1 colors plus a separately interpolated alpha.
+	BC3,
+	//	BPTC: 16 bytes per 4x4 block (1 byte per pixel), RGBA at a much better quality than BC3.
+	BC7
+};
+
+//	The levels of a cooked texture where they already are, e.g. inside a mapped AssetPack; the size of each is GetLevelSize().
+struct CookedTextureView
+{
+	TextureFormat Format = TextureFormat::RGBA8;
+	int Width = 0, Height = 0;
+	std::vector<const unsigned char*> Levels;
+};
+
+//	A texture ready for the GPU: every mip level, already in its final format, bottom row first as OpenGL expects.
+struct CookedTexture
+{
+	TextureFormat Format = TextureFormat::RGBA8;
+	int Width = 0, Height = 0;
+	//	Level 0 is the full size image, each next one half the size of the last, down to 1x1.
+	std::vector<std::vector<unsigned char>> Levels;
+
+	//	The bytes of all the levels, i.e. what the texture takes on the GPU.
+	size_t GetSize() const;
+	CookedTextureView GetView() const;
+};
+
+/**
+*	Turns images into CookedTextures, offline or at runtime, and reads and writes them as KTX (1.1) files.
+*
+*	Cooking decodes the image once, builds the whole mip chain with a box filter (weighted by alpha, so transparent
+*	pixels don't bleed their color into the smaller levels) and encodes every level to the chosen BCn format.
+*	The blocks of a level are encoded on all the threads of the JobSystem.
+*	Loading a cooked texture is then reading a file and one glCompressedTexImage2D per level: there is no decode,
+*	and a BC1 texture takes 1/8 of the memory of the same RGBA8 one (BC3 and BC7 1/4), before counting the mip chain.
+*
+*	KTX is used because it's made for OpenGL: it stores the GL internal format and rows in the order glTexImage2D
+*	takes them, so nothing has to be converted at load time.
+*
+*	The encoders favour speed over quality: BC1 and the colors of BC3 fit their endpoints to the principal axis of
+*	the block, and BC7 only uses mode 6 (one subset, RGBA endpoints, 16 levels).
+*/
+class TextureCooker
+{
+public:
+	struct Options
+	{
+		TextureFormat Format = TextureFormat::BC7;
+		bool Mipmaps = true;
+	};
+
+	//	Returns true if the arguments ask for cooking (--cook), and fills `options` and `inputs` from the rest of them:
+	//	--format rgba8|bc1|bc3|bc7, --no-mips, and the images to cook.
+	static bool ParseArgs(int argc, char** argv, Options& options, std::vector<std::string>& inputs);
+	//	Cooks every input to a .ktx next to it; returns how many failed.
+	static int Run(const Options& options, const std::vector<std::string>& inputs);
+
+	//	`pixels` is `width` * `height` RGBA8 pixels, bottom row first.
+	static CookedTexture Cook(const unsigned char* pixels, int width, int height, const Options& options);
+	//	Decodes the image with stb_image and cooks it; false if it couldn't be decoded.
+	static bool CookFile(const std::string& path, const Options& options, CookedTexture& texture);
+
+	static bool Write(const std::string& path, const CookedTexture& texture);
+	//	Only reads the formats Write() writes.
+	static bool Read(const std::string& path, CookedTexture& texture);
+
+	//	The path `path` is cooked to: the same name with a .ktx extension.
+	static std::string GetCookedPath(const std::string& path);
+	static bool IsCookedPath(const std::string& path);
+
+	static const char* GetFormatName(TextureFormat format);
+	static unsigned int GetGLInternalFormat(TextureFormat format);
+	//	Whether the current context can sample the format; needs a context.
+	static bool IsSupported(TextureFormat format);
+	//	The bytes of one level in the format.
+	static size_t GetLevelSize(TextureFormat format, int width, int height);
+};
@@ -0,0 +1,233 @@
+#include "TextureStreamer.h"
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "GLStateCache.h"
+#include "Instrumentor.h"
+#include "stb_image/stb_image.h"
+
+#include "imgui/imgui.h"
+
+#include <cstring>
+#include <iostream>
+
+
+static thread_local TextureStreamer* s_Current = nullptr;
+
+TextureStreamer::TextureStreamer()
+    : m_RendererID(0), m_MappedData(nullptr), m_Fences{}, m_SlotTaken{}
+{
+    ASSERT(IsSupported());
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+
+    GLsizeiptr size = (GLsizeiptr)SlotSize * SlotCount;
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLCall(glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags));
+    GLCall(m_MappedData = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+    ASSERT(m_MappedData);
+
+    //  Anything bound to the unpack buffer turns every later glTexImage2D pointer into an offset into it.
+    GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    //  The copy jobs write into the mapping, so it has to outlive them.
+    JobSystem::Get().Wait(m_Jobs);
+
+    for (const std::shared_ptr<Request>& request : m_Requests)
+    {
+        if (request->Pixels)
+            stbi_image_free(request->Pixels);
+    }
+
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+    GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+    GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+bool TextureStreamer::IsSupported()
+{
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+TextureStreamer* TextureStreamer::Get()
+{
+    return s_Current;
+}
+
+void TextureStreamer::MakeCurrent(TextureStreamer* streamer)
+{
+    s_Current = streamer;
+}
+
+void TextureStreamer::Load(Texture& texture, const std::string& path)
+{
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->Target = &texture;
+    request->Path = path;
+    request->Status = Request::Decoding;
+    request->Pixels = nullptr;
+    request->Width = 0;
+    request->Height = 0;
+    request->Slot = -1;
+    request->Started = std::chrono::steady_clock::now();
+    m_Requests.push_back(request);
+
+    JobSystem::Get().Run([request]()
+    {
+        PROFILE_SCOPE("stbi_load");
+        int bpp = 0;
+        //  The global flag isn't safe to set from several workers at once.
+        stbi_set_flip_vertically_on_load_thread(1);
+        request->Pixels = stbi_load(request->Path.c_str(), &request->Width, &request->Height, &bpp, 4);
+        request->Status.store(Request::Decoded, std::memory_order_release);
+    }, &m_Jobs);
+}
+
+void TextureStreamer::Cancel(const Texture& texture)
+{
+    //  The jobs may still be running; the request is dropped by Update() once they are done.
+    for (const std::shared_ptr<Request>& request : m_Requests)
+    {
+        if (request->Target == &texture)
+            request->Target = nullptr;
+    }
+}
+
+int TextureStreamer::FindFreeSlot()
+{
+    for (int i = 0; i < (int)SlotCount; i++)
+    {
+        if (m_SlotTaken[i])
+            continue;
+
+        if (m_Fences[i])
+        {
+            GLenum result = glClientWaitSync(m_Fences[i], 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                continue;
+
+            glDeleteSync(m_Fences[i]);
+            m_Fences[i] = nullptr;
+        }
+        return i;
+    }
+    return -1;
+}
+
+void TextureStreamer::Update()
+{
+    PROFILE_FUNCTION();
+
+    for (size_t i = 0; i < m_Requests.size();)
+    {
+        Request& request = *m_Requests[i];
+        int status = request.Status.load(std::memory_order_acquire);
+        bool done = false;
+
+        if (status == Request::Decoded)
+        {
+            size_t size = (size_t)request.Width * request.Height * 4;
+            if (!request.Target || !request.Pixels)
+            {
+                if (!request.Pixels)
+                {
+                    std::cout << "[TextureStreamer] Failed to load " << request.Path << '\n';
+                    //  It keeps the placeholder, like a synchronous load that failed keeps an empty texture.
+                    if (request.Target)
+                        request.Target->OnStreamed(1, 1);
+                }
+                done = true;
+            }
+            else if (size > SlotSize)
+            {
+                Upload(request);
+                done = true;
+            }
+            else
+            {
+                request.Slot = FindFreeSlot();
+                if (request.Slot >= 0)
+                {
+                    m_SlotTaken[request.Slot] = true;
+                    request.Status.store(Request::Copying, std::memory_order_relaxed);
+
+                    std::shared_ptr<Request> shared = m_Requests[i];
+                    unsigned char* destination = m_MappedData + (size_t)request.Slot * SlotSize;
+                    JobSystem::Get().Run([shared, destination, size]()
+                    {
+                        PROFILE_SCOPE("TextureStreamer Copy");
+                        std::memcpy(destination, shared->Pixels, size);
+                        stbi_image_free(shared->Pixels);
+                        shared->Pixels = nullptr;
+                        shared->Status.store(Request::Copied, std::memory_order_release);
+                    }, &m_Jobs);
+                }
+            }
+        }
+        else if (status == Request::Copied)
+        {
+            if (request.Target)
+                Upload(request);
+            m_SlotTaken[request.Slot] = false;
+            done = true;
+        }
+
+        if (done)
+        {
+            if (request.Pixels)
+                stbi_image_free(request.Pixels);
+            m_Requests.erase(m_Requests.begin() + i);
+        }
+        else
+            i++;
+    }
+}
+
+void TextureStreamer::Upload(Request& request)
+{
+    PROFILE_FUNCTION();
+    //  The texture never had a bindless handle (see BindlessTextures::SetStreaming()), so it can still be re-specified.
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, request.Target->GetRendererID());
+    //  Allocated while no unpack buffer is bound, where a null pointer still means "no data".
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, request.Width, request.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+    if (request.Slot >= 0)
+    {
+        //  With the buffer bound, the pointer is an offset into it.
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, request.Width, request.Height, GL_RGBA, GL_UNSIGNED_BYTE,
+            (const void*)((size_t)request.Slot * SlotSize)));
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        GLCall(m_Fences[request.Slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    }
+    else
+    {
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, request.Width, request.Height, GL_RGBA, GL_UNSIGNED_BYTE, request.Pixels));
+    }
+
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+    request.Target->OnStreamed(request.Width, request.Height);
+
+    m_Stats.Uploaded++;
+    m_Stats.BytesUploaded += (unsigned long long)request.Width * request.Height * 4;
+    m_Stats.LastLoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - request.Started).count();
+}
+
+void TextureStreamer::OnImGuiRender()
+{
+    ImGui::Text("Textures loading: %u", GetPendingCount());
+    ImGui::Text("Uploaded: %u (%.1f MB), last took %.1f ms", m_Stats.Uploaded, m_Stats.BytesUploaded / (1024.0 * 1024.0), m_Stats.LastLoadTime);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+#include "JobSystem.h"
+
+class Texture;
+
+/**
+*	Loads textures without stalling the render thread.
+*
+*	A Texture made with TextureLoad::Async gets a 1x1 placeholder straight away and is usable (it just shows grey, or
+*	white through Renderer2D's bindless mode, which can't give it a handle until it has its real size),
+*	while its file is decoded on the JobSystem. Once the pixels are decoded, Update() gives the load one of the
+*	slots of a pixel buffer (GL_PIXEL_UNPACK_BUFFER) that stays mapped for its whole life, a worker copies the pixels
+*	into it, and the next Update() issues glTexSubImage2D from the buffer, which lets the driver do the transfer
+*	without holding up the CPU. Each slot is fenced after its upload and isn't handed out again until the GPU has
+*	read it, like the regions of a StreamingVertexBuffer.
+*
+*	Only the render thread calls into the streamer; images that don't fit in a slot are uploaded straight from memory.
+*	Without ARB_buffer_storage there is no streamer, and Textures load the old, synchronous way.
+*/
+class TextureStreamer
+{
+public:
+	struct Stats
+	{
+		unsigned int Uploaded = 0;
+		unsigned long long BytesUploaded = 0;
+		//	From the Texture being made to its pixels being uploaded, for the last texture; in milliseconds.
+		double LastLoadTime = 0.0;
+	};
+
+	static const unsigned int SlotCount = 4;
+	//	Enough for a 2048x2048 RGBA8 image.
+	static const unsigned int SlotSize = 2048 * 2048 * 4;
+
+	TextureStreamer();
+	~TextureStreamer();
+
+	static bool IsSupported();
+
+	//	The streamer Textures made with TextureLoad::Async use; null means they load synchronously.
+	static TextureStreamer* Get();
+	static void MakeCurrent(TextureStreamer* streamer);
+
+	//	Called by Texture; starts decoding `path`. `texture` keeps its placeholder until Update() uploads the pixels.
+	void Load(Texture& texture, const std::string& path);
+	//	Called by Texture's destructor, so a texture is never written to after it's gone.
+	void Cancel(const Texture& texture);
+	//	Moves every load along as far as it can go without waiting; called once per frame.
+	void Update();
+
+	inline unsigned int GetPendingCount() const { return (unsigned int)m_Requests.size(); }
+	inline const Stats& GetStats() const { return m_Stats; }
+	void OnImGuiRender();
+
+private:
+	struct Request
+	{
+		enum State { Decoding, Decoded, Copying, Copied };
+
+		//	Null once the texture has been destroyed.
+		Texture* Target;
+		std::string Path;
+		std::atomic<int> Status;
+		unsigned char* Pixels;
+		int Width, Height;
+		int Slot;
+		std::chrono::steady_clock::time_point Started;
+	};
+
+	//	A slot the GPU is done with and no load is using, or -1.
+	int FindFreeSlot();
+	void Upload(Request& request);
+
+private:
+	unsigned int m_RendererID;
+	unsigned char* m_MappedData;
+	GLsync m_Fences[SlotCount];
+	bool m_SlotTaken[SlotCount];
+
+	std::vector<std::shared_ptr<Request>> m_Requests;
+	//	Counts the decode and copy jobs still running, which the destructor has to wait for.
+	JobCounter m_Jobs;
+
+	Stats m_Stats;
+};
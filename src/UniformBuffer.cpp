@@ -0,0 +1,33 @@
+#include "UniformBuffer.h"
+
+#include "Renderer.h"
+#include "GLStateCache.h"
+
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int binding)
+    : m_RendererID(0), m_Size(size), m_Binding(binding)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    //  Rewritten every frame or so, and only read by the GPU.
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+    BindBase();
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset) const
+{
+    ASSERT(offset + size <= m_Size);
+    GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::BindBase() const
+{
+    GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID));
+}
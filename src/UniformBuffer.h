@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+*	A GL_UNIFORM_BUFFER bound to one uniform block binding point for as long as it lives, so every program whose
+*	block is bound to the same point (glUniformBlockBinding) reads it, without a glUniform* call per program.
+*	The data has to follow the block's layout; std140 is the one that is the same on every driver.
+*/
+class UniformBuffer
+{
+private:
+	unsigned int m_RendererID;
+	unsigned int m_Size;
+	unsigned int m_Binding;
+
+public:
+	//	`size` bytes, left undefined until SetData().
+	UniformBuffer(unsigned int size, unsigned int binding);
+	~UniformBuffer();
+
+	UniformBuffer(const UniformBuffer&) = delete;
+	UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+	//	Replaces `size` bytes of the buffer starting at `offset` bytes.
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0) const;
+
+	//	Binds it to its binding point again, in case something else was bound there since.
+	void BindBase() const;
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetSize() const { return m_Size; }
+	inline unsigned int GetBinding() const { return m_Binding; }
+};
@@ -1,20 +1,24 @@
 #include "VertexArray.h"
 
 #include "VertexBufferLayout.h"
+#include "StreamingVertexBuffer.h"
 #include "Renderer.h"
+#include "GLStateCache.h"
 
 VertexArray::VertexArray()
+	: m_AttributeCount(0)
 {
 	GLCall(glGenVertexArrays(1, &m_RendererID));
-	GLCall(glBindVertexArray(m_RendererID));
+	GLStateCache::Get().BindVertexArray(m_RendererID);
 }
 
 VertexArray::~VertexArray()
 {
+	GLStateCache::Get().OnDeleteVertexArray(m_RendererID);
 	GLCall(glDeleteVertexArrays(1, &m_RendererID));
 }
 
-void VertexArray::AddBuffer(const VertexBuffer& vbo, const VertexBufferLayout& layout)
+void VertexArray::AddBuffer(const VertexBuffer& vbo, const VertexBufferLayout& layout, unsigned int firstAttribute)
 {
 	//(*this).Bind(); or this->Bind()
 	// or just
@@ -22,29 +26,56 @@ void VertexArray::AddBuffer(const VertexBuffer& vbo, const VertexBufferLayout& l
 	//	Bind the VBO
 	vbo.Bind();
 
+	SetLayout(layout, firstAttribute);
+}
+
+void VertexArray::AddBuffer(const StreamingVertexBuffer& vbo, const VertexBufferLayout& layout, unsigned int firstAttribute)
+{
+	Bind();
+	vbo.Bind();
+
+	SetLayout(layout, firstAttribute);
+}
+
+void VertexArray::SetLayout(const VertexBufferLayout& layout, unsigned int firstAttribute)
+{
 	/*Setup The Layout*/
 	const auto& elements = layout.GetElements();
 	unsigned int offset = 0;
+	unsigned int index = firstAttribute == NextAttribute ? m_AttributeCount : firstAttribute;
 	for (unsigned int i=0; i < elements.size(); i++)
 	{
 		const auto& element = elements[i];
-		//  this can be called anywhere; it enables this buffer to be used
-		GLCall(glEnableVertexAttribArray(i));
-		//  The data for the positions
-		//  @Exp: Notice how the layout of this Vertex Buffer is specified here
-		GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
-
-		//	At this point, th esize of each type is needed.
-		offset += element.count * VertexBufferLayoutElement::GetSizeOfType(element.type);
+		unsigned int typeSize = VertexBufferLayoutElement::GetSizeOfType(element.type);
+
+		//	An attribute holds at most 4 components, so bigger elements (matrices) are split over consecutive locations.
+		for (unsigned int component = 0; component < element.count; component += 4)
+		{
+			unsigned int count = element.count - component < 4 ? element.count - component : 4;
+
+			//  this can be called anywhere; it enables this buffer to be used
+			GLCall(glEnableVertexAttribArray(index));
+			//  The data for the positions
+			//  @Exp: Notice how the layout of this Vertex Buffer is specified here
+			GLCall(glVertexAttribPointer(index, count, element.type, element.normalized, layout.GetStride(), (const void*)(size_t)offset));
+			//	0 is the default; it's only set so an index reused from a different layout can't keep an old divisor.
+			GLCall(glVertexAttribDivisor(index, layout.GetDivisor()));
+
+			//	At this point, th esize of each type is needed.
+			offset += count * typeSize;
+			index++;
+		}
 	}
+	if (index > m_AttributeCount)
+		m_AttributeCount = index;
 }
 
 void VertexArray::Bind() const
 {
-	GLCall(glBindVertexArray(m_RendererID));
+	GLStateCache::Get().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
-	GLCall(glBindVertexArray(0));
+	GLStateCache::Get().BindVertexArray(0);
 }
\ No newline at end of file
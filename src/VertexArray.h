@@ -4,18 +4,39 @@
 //#include "VertexBufferLayout.h"
 
 class VertexBufferLayout;
+class StreamingVertexBuffer;
 
 class VertexArray
 {
 private:
 	unsigned int m_RendererID;
+	//	One past the highest attribute index used; where the next AddBuffer() starts by default.
+	unsigned int m_AttributeCount;
 	
 public:
 	VertexArray();
 	~VertexArray();
 
-	void AddBuffer(const VertexBuffer& vbo, const VertexBufferLayout& layout);
+	//	Passed as `firstAttribute` to continue after the attributes of the buffers added before.
+	static const unsigned int NextAttribute = ~0u;
+
+	/**
+	*	The layout's attributes take consecutive indices from `firstAttribute`. By default that's right after the
+	*	highest index used so far, so e.g. a per-vertex buffer with 2 attributes takes locations 0 and 1, and a
+	*	per-instance buffer added after it starts at location 2; an explicit index puts a layout where the shader
+	*	expects it, whatever was added before. An element with more than 4 components (a mat4 is Push<float>(16))
+	*	takes one location for every 4 of them, as GLSL does.
+	*/
+	void AddBuffer(const VertexBuffer& vbo, const VertexBufferLayout& layout, unsigned int firstAttribute = NextAttribute);
+	void AddBuffer(const StreamingVertexBuffer& vbo, const VertexBufferLayout& layout, unsigned int firstAttribute = NextAttribute);
 
 	void Bind() const;
 	void Unbind() const;
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline unsigned int GetAttributeCount() const { return m_AttributeCount; }
+
+private:
+	//	Sets up the attributes for whichever buffer is bound to GL_ARRAY_BUFFER.
+	void SetLayout(const VertexBufferLayout& layout, unsigned int firstAttribute);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "VertexBuffer.h"
 
 #include "Renderer.h"
+#include "GLStateCache.h"
 
 
 
@@ -9,7 +10,7 @@ VertexBuffer::VertexBuffer(const void* data, unsigned int size, bool isStatic)
     GLCall(glGenBuffers(1, &m_Renderer_ID));
     //  Specifies what the buffer is used for
     //  binding the buffer shows it's to be used
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_Renderer_ID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_Renderer_ID);
 
     if (isStatic) {
         GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
@@ -22,16 +23,23 @@ VertexBuffer::VertexBuffer(const void* data, unsigned int size, bool isStatic)
 
 VertexBuffer::~VertexBuffer()
 {
+    GLStateCache::Get().OnDeleteBuffer(m_Renderer_ID);
     GLCall(glDeleteBuffers(1, &m_Renderer_ID));
 }
 
+void VertexBuffer::SetData(const void* data, unsigned int size, unsigned int offset) const
+{
+    Bind();
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 void VertexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_Renderer_ID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_Renderer_ID);
 }
 
 
 void VertexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
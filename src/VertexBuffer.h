@@ -15,6 +15,11 @@ public:
 	VertexBuffer(const void* data, unsigned int size, bool isStatic=true);
 	~VertexBuffer();
 
+	//	Replaces `size` bytes of the buffer starting at `offset` bytes; the buffer must be large enough.
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0) const;
+
 	void Bind() const;
 	void Unbind() const;
+
+	inline unsigned int GetRendererID() const { return m_Renderer_ID; }
 };
\ No newline at end of file
@@ -31,10 +31,12 @@ class VertexBufferLayout
 private:
 	std::vector<VertexBufferLayoutElement> m_Elements;
 	unsigned int m_Stride;
+	//	0 means the attributes advance once per vertex; N means once every N instances.
+	unsigned int m_Divisor;
 
 public:
 	VertexBufferLayout()
-		: m_Stride(0) {}
+		: m_Stride(0), m_Divisor(0) {}
 
 	~VertexBufferLayout() = default;
 
@@ -72,6 +74,14 @@ public:
 		m_Stride += count * VertexBufferLayoutElement::GetSizeOfType(GL_UNSIGNED_BYTE);
 	}
 
+	/**
+	*	Makes every attribute of this layout per-instance instead of per-vertex: with a divisor of 1 the next element
+	*	of the buffer is used for each instance of an instanced draw (glVertexAttribDivisor).
+	*	A buffer is either all per-vertex or all per-instance, so the whole layout has the one step rate.
+	*/
+	inline void SetDivisor(unsigned int divisor) { m_Divisor = divisor; }
+	inline unsigned int GetDivisor() const { return m_Divisor; }
+
 	inline const std::vector<VertexBufferLayoutElement> GetElements() const { return m_Elements; }
 	inline unsigned int GetStride() const { return m_Stride; }
 	
@@ -1,11 +1,13 @@
 #include "Test.h"
 #include "imgui/imgui.h"
 
+#include <chrono>
+
 
 namespace test
 {
 	TestMenu::TestMenu(Test*& currentTestPointer)
-		: m_CurrentTest(currentTestPointer)
+		: m_CurrentTest(currentTestPointer), m_LastOpenTime(0.0)
 	{
 	}
 
@@ -19,8 +21,16 @@ namespace test
 		for (auto& test : m_Tests)
 		{
 			if (ImGui::Button(test.first.c_str()))
+			{
+				//	Mostly loading textures and shaders, unless the AssetManager still has them.
+				auto start = std::chrono::high_resolution_clock::now();
 				m_CurrentTest = test.second();
+				m_LastOpenTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+				std::cout << "Opened " << test.first << " in " << m_LastOpenTime << " ms\n";
+			}
 		}
+		if (m_LastOpenTime > 0.0)
+			ImGui::Text("Last test took %.1f ms to open", m_LastOpenTime);
 	}
 
 }
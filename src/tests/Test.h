@@ -48,8 +48,13 @@ namespace test {
 			m_Tests.push_back(std::make_pair(name, []() {return new T(); }));
 		}
 
+		//	Every registered test by name, with the function that creates it; e.g. for running them all in a benchmark.
+		inline const std::vector<std::pair<std::string, std::function<Test* ()>>>& GetTests() const { return m_Tests; }
+
 	private:
 		Test*& m_CurrentTest;
+		//	How long the constructor of the last test opened took, in milliseconds.
+		double m_LastOpenTime;
 		/**
 		*	Now, this vector matches each test to its name.
 		* 
@@ -2,6 +2,9 @@
 
 #include "TestBatchRendering.h"
 
+#include "AssetManager.h"
+#include "FrameUniforms.h"
+
 
 namespace test
 {
@@ -59,7 +62,8 @@ namespace test
 
         m_IBO = std::make_unique<IndexBuffer>(indices, 12);
 
-        m_Shader = std::make_unique<Shader>("res/shaders/ep28/BasicBatch.shader");
+        //  Just positions, moved by u_Model, all in u_Color.
+        m_Shader = AssetManager::Get().GetShaderVariant("res/shaders/Batch/Batch.shader", { "MODEL_MATRIX" });
         m_Shader->Bind();
         m_Shader->SetUniform4f("u_Color", glm::vec4(0.65f, 0.08f, 0.58f, 1.0f));
         //m_Texture = std::make_unique<Texture>("res/textures/star_rasengan.png");
@@ -89,11 +93,12 @@ namespace test
         //  setup uniform
         //shader.SetUniform4f("u_Color", r, 0.05f, 0.58f, 1.0f);
         glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-        glm::mat4 mvp = m_Proj * m_View * model;
+        //  The camera goes to the Frame block once; the draw only has its model matrix.
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
 
-        //  Specifying different MVP matrix to render more than one models
+        //  Specifying different model matrix to render more than one models
         m_Shader->Bind();
-        m_Shader->SetUniformMat4("u_MVP", mvp);
+        m_Shader->SetUniformMat4("u_Model", model);
         //  the Renderer Binds the VAO and IBO and the Shader
         renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
 
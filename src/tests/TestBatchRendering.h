@@ -33,8 +33,8 @@ namespace test
 		std::unique_ptr<VertexArray> m_VAO;
 		std::unique_ptr<IndexBuffer> m_IBO;
 		std::unique_ptr<VertexBuffer> m_VBO;
-		std::unique_ptr<Shader> m_Shader;
-		std::unique_ptr<Texture> m_Texture;
+		std::shared_ptr<Shader> m_Shader;
+		std::shared_ptr<Texture> m_Texture;
 
 		glm::mat4 m_Proj, m_View;
 		glm::vec3 m_TranslationA;//, m_TranslationB;
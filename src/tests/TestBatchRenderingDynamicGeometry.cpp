@@ -1,7 +1,10 @@
 #include <iostream>
 #include "TestBatchRenderingDynamicGeometry.h"
 
-#include "stb_image/stb_image.h"
+#include "AssetManager.h"
+#include "FrameUniforms.h"
+
+#include "GLStateCache.h"
 #include <array>
 
 //  Because Arrays are non-assignable
@@ -33,38 +36,13 @@ struct Vertex
     float TexID;
 };
 
-static GLuint LoadTexture(const std::string& path)
-{
-    int w, h, bits;
-
-    stbi_set_flip_vertically_on_load(1);
-    //  For last parameter, could use STBI_rgb -> 3
-    auto* pixels = stbi_load(path.c_str(), &w, &h, &bits, 4);
-    GLuint textureID;
-
-    GLCall(glCreateTextures(GL_TEXTURE_2D, 1, &textureID));
-    GLCall(glBindTexture(GL_TEXTURE_2D, textureID));
-
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-
-    //  So for this, would use GL_RGBA8
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-
-    stbi_image_free(pixels);
-
-    return textureID;
-    
-}
 namespace test
 {
 
     TestBatchRenderingDynamicGeometry::TestBatchRenderingDynamicGeometry()
         : m_Name{ "Batch Rendering Test - Textures" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
         m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f))),
-        m_TranslationA(200, 200, 0)//, m_TranslationB(400, 200, 0)
+        m_TranslationA(200, 200, 0), m_CreatedAt(std::chrono::steady_clock::now())//, m_TranslationB(400, 200, 0)
     {
 
 
@@ -119,29 +97,31 @@ namespace test
         layout.Push<float>(1u); //  tex index
         m_VAO->AddBuffer(*m_VBO, layout);
 
-        m_IBO = std::make_unique<IndexBuffer>(nullptr, 6 * 1000, false);
+        //  The quad indices never change, so the shared, precomputed QuadIndexBuffer is used instead of
+        //  a dynamic Index Buffer that was regenerated and uploaded every frame.
 
-        m_Shader = std::make_unique<Shader>("res/shaders/ep28/BasicBatch-Textures_v2.shader");
+        //  The sampler array as big as the GPU allows, rather than a fixed size.
+        m_Shader = AssetManager::Get().GetShaderVariant("res/shaders/Batch/Batch.shader", { "VERTEX_COLOR", "TEXTURED", "MAX_TEXTURES=" + std::to_string(Shader::GetMaxTextureUnits()), "MODEL_MATRIX" });
         
         m_Shader->Bind();
 
         //  Loading Textures
 
-        m_Tex1 = LoadTexture("res/textures/star_rasengan.png");
-        m_Tex2 = LoadTexture("res/textures/T-REX.png");
-        m_Tex3 = LoadTexture("res/textures/red_diamond_heart.png");
-        m_Tex4 = LoadTexture("res/textures/morning glory.jpg");
-        m_Tex5 = LoadTexture("res/textures/shark.jpg");
+        m_Tex1 = AssetManager::Get().GetTexture("res/textures/star_rasengan.png", TextureLoad::Async);
+        m_Tex2 = AssetManager::Get().GetTexture("res/textures/T-REX.png", TextureLoad::Async);
+        m_Tex3 = AssetManager::Get().GetTexture("res/textures/red_diamond_heart.png", TextureLoad::Async);
+        m_Tex4 = AssetManager::Get().GetTexture("res/textures/morning glory.jpg", TextureLoad::Async);
+        m_Tex5 = AssetManager::Get().GetTexture("res/textures/shark.jpg", TextureLoad::Async);
 
         //int samplers[] = { (int)m_MorningGloryTex, (int)m_RasenganTex, (int)m_DaisyTex };
         int samplers[] = { 0, 1, 2, 3, 4 };
-        m_Shader->SetUniform1iv("u_Textures", samplers);
+        m_Shader->SetUniform1iv("u_Textures", 5, samplers);
 
-        std::cout << "Tex1: " << (unsigned int)m_Tex1 << '\n';
-        std::cout << "Tex2: " << (unsigned int)m_Tex2 << '\n';
-        std::cout << "Tex3: " << (unsigned int)m_Tex3 << '\n';
-        std::cout << "Tex4: " << (unsigned int)m_Tex4 << '\n';
-        std::cout << "Tex5: " << (unsigned int)m_Tex5 << '\n';
+        std::cout << "Tex1: " << m_Tex1->GetRendererID() << '\n';
+        std::cout << "Tex2: " << m_Tex2->GetRendererID() << '\n';
+        std::cout << "Tex3: " << m_Tex3->GetRendererID() << '\n';
+        std::cout << "Tex4: " << m_Tex4->GetRendererID() << '\n';
+        std::cout << "Tex5: " << m_Tex5->GetRendererID() << '\n';
     }
 
     TestBatchRenderingDynamicGeometry::~TestBatchRenderingDynamicGeometry()
@@ -191,88 +171,19 @@ namespace test
     }
 
 
-    static void CreateQuadIndices(int numOfIndicesPerQuad, unsigned int numOfQuads, unsigned int*& outArray)
-    {
-        //   Empty Array
-        //static unsigned int prevCount = numOfQuads;
-        /*if (prevCount != numOfQuads)
-        {*/
-        //delete[] outArray;
-        //outArray = new unsigned int[numOfIndicesPerQuad * (int)numOfQuads] {};
-        //}
-
-        unsigned int noipq = numOfIndicesPerQuad;
-        /*   0 ,1, 2,    //  First Triangle
-            2, 3, 0,    //  Second Triangle for first 
 
-            4, 5, 6, 6, 7, 4, // second square
-            8, 9, 10, 10, 11, 8 // third square*/
-        //  The outer keeps track of which quad's indices its drawing
-        for (unsigned int i= 0; i < numOfQuads; i+=1)
-        {
-            unsigned int indexStride = i * numOfIndicesPerQuad;
-            unsigned int valueStride = i * 4;
-            //std::cout << indexStride;
-            for (unsigned int j = 0; j < noipq; j++)
-            {
-                if (j < noipq / 2)
-                {
-                    outArray[j + indexStride] = j + valueStride;
-                }
-                else if(j >= noipq /2 && j != noipq - 1)
-                {
-                    outArray[j + indexStride] = (j - 1) + valueStride;
-                    //std::cout << "Ran!\n";
-                }
-                else
-                {
-                    outArray[j + indexStride] = outArray[indexStride];
-
-                }
-            }
-        }
-        //prevCount = numOfQuads;
-    }
-   
-    static void printArray(unsigned int*& arrayRef, int size)
+    void TestBatchRenderingDynamicGeometry::OnRender()
     {
-        static int once = 0;
-        int count = 0;
-        //  Print every 50 frames
-        if (once % 100 == 0)
+        //  With TextureLoad::Async the first frame comes before the textures do, which show grey until then.
+        auto now = std::chrono::steady_clock::now();
+        if (m_TimeToFirstFrame < 0.0)
         {
-            for (unsigned int i = 0; i < 1000u; i++)
-            {
-                if (arrayRef[i] < 1000u)
-                {
-                    count += 1;
-                }
-                else
-                {
-                    break;
-                }
-            }
-            for (int i = 0; i < size; i++)
-            {
-                
-
-                if (i + 1 % 5 == 0)
-                {
-                    std::cout << arrayRef[i] << "\n";
-                    continue;
-                }
-                else
-                {
-                    std::cout << arrayRef[i] << " ";
-                }
-            }
-           std::cout << "\nSize is: " << count << "\n";
+            m_TimeToFirstFrame = std::chrono::duration<double, std::milli>(now - m_CreatedAt).count();
+            std::cout << "Time to first frame: " << m_TimeToFirstFrame << " ms\n";
         }
-        once += 1;
-    }
+        if (m_TimeToLoaded < 0.0 && m_Tex1->IsLoaded() && m_Tex2->IsLoaded() && m_Tex3->IsLoaded() && m_Tex4->IsLoaded() && m_Tex5->IsLoaded())
+            m_TimeToLoaded = std::chrono::duration<double, std::milli>(now - m_CreatedAt).count();
 
-    void TestBatchRenderingDynamicGeometry::OnRender()
-    {
         GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
         //GLCall(glClear(GL_COLOR_BUFFER_BIT));
         Renderer renderer;
@@ -325,29 +236,9 @@ namespace test
         }
 
 
-        //  Dynamically making 5 indices data;
-
-        unsigned int numOfIndicesPerQuad = 6;
-        unsigned int* indices = new unsigned int[(int)numOfIndicesPerQuad * m_QuadCount];
-
-        //printArray(indices, (int)numOfIndicesPerQuad * m_QuadCount);
-        CreateQuadIndices(numOfIndicesPerQuad, (unsigned int)m_QuadCount, indices);
-        printArray(indices, (int)numOfIndicesPerQuad * m_QuadCount);
-        
-
-        static int once = 0;
-        
-        //  Display every 100 frames
-        if (once % 100 == 0)
-        {
-            std::cout << "Size of Vertex: " << sizeof(Vertex) << "\n";
-            std::cout << "Size of Vertices: " << sizeof(vertices) << "\n";
-            std::cout << "Size of Indices: " << sizeof(indices) << "\n";
-            std::cout << "Size of Unsigned Int: " << sizeof(unsigned int) << "\n";
-            std::cout << "No. Of Indices: " << (unsigned int)m_QuadCount * numOfIndicesPerQuad << "\n";
-            std::cout << "Calculated Size: " << sizeof(indices) * (unsigned int)m_QuadCount * numOfIndicesPerQuad << "\n";
-        }
-        once += 1;
+        //  No index data is made here anymore: the first 6 * m_QuadCount indices of the shared QuadIndexBuffer
+        //  are exactly the ones this needs.
+        unsigned int indexCount = QuadIndexBuffer::IndicesPerQuad * (unsigned int)m_QuadCount;
 
         m_VBO->Bind();
         //m_IBO->Bind();
@@ -371,11 +262,6 @@ namespace test
         //  this effectively populates the Vertex Buffer with the vertex data every frame.
         GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices));
 
-        //  To dynamically add the index buffer data:
-        //  Could do:
-        //GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, (unsigned int)m_QuadCount * numOfIndicesPerQuad * sizeof(unsigned int), indices));
-        //  OR:
-        GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices) * (unsigned int)m_QuadCount * numOfIndicesPerQuad , indices));
 
 
 
@@ -384,28 +270,27 @@ namespace test
         //  setup uniform
         //shader.SetUniform4f("u_Color", r, 0.05f, 0.58f, 1.0f);
         glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-        glm::mat4 mvp = m_Proj * m_View * model;
+        //  The camera goes to the Frame block once; the draw only has its model matrix.
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
 
-        //  Specifying different MVP matrix to render more than one models
+        //  Specifying different model matrix to render more than one models
         m_Shader->Bind();
         //  These indices here, the first arguments are the Textures'IDs
         //  They should correspond to the Texture ID in the Vertex Data.
-        glBindTextureUnit(0, m_Tex1);
-        glBindTextureUnit(1, m_Tex2);
-        glBindTextureUnit(2, m_Tex3);
-        glBindTextureUnit(3, m_Tex4);
-        glBindTextureUnit(4, m_Tex5);
+        GLStateCache::Get().BindTextureUnit(0, m_Tex1->GetRendererID());
+        GLStateCache::Get().BindTextureUnit(1, m_Tex2->GetRendererID());
+        GLStateCache::Get().BindTextureUnit(2, m_Tex3->GetRendererID());
+        GLStateCache::Get().BindTextureUnit(3, m_Tex4->GetRendererID());
+        GLStateCache::Get().BindTextureUnit(4, m_Tex5->GetRendererID());
 
-        m_Shader->SetUniformMat4("u_MVP", mvp);
+        m_Shader->SetUniformMat4("u_Model", model);
         //  the Renderer Binds the VAO and IBO and the Shader
-        renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
+        renderer.Draw(*m_VAO, QuadIndexBuffer::Get(), *m_Shader, indexCount);
 
         /*m_VBO->Unbind();
         m_IBO->Unbind();
         m_Shader->Unbind();*/
 
-        delete[] indices;
-
     }
 
     void TestBatchRenderingDynamicGeometry::OnImGuiRender()
@@ -425,6 +310,11 @@ namespace test
         ImGui::SliderFloat("y_slider_B", &m_TranslationB.y, 0.0f, 540.0f);*/
 
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+        ImGui::Text("Time to first frame: %.1f ms", m_TimeToFirstFrame);
+        if (m_TimeToLoaded >= 0.0)
+            ImGui::Text("All textures loaded after %.1f ms", m_TimeToLoaded);
+        else
+            ImGui::Text("Textures loading...");
 
     }
 }
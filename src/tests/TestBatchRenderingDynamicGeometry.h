@@ -2,12 +2,14 @@
 #pragma once
 
 #include <memory>
+#include <chrono>
 
 #include "Test.h"
 
 #include "Renderer.h"
+#include "QuadIndexBuffer.h"
 #include "imgui/imgui.h"
-//#include "Texture.h"
+#include "Texture.h"
 #include "VertexBufferLayout.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -31,9 +33,8 @@ namespace test
 		const char* m_Name;
 
 		std::unique_ptr<VertexArray> m_VAO;
-		std::unique_ptr<IndexBuffer> m_IBO;
 		std::unique_ptr<VertexBuffer> m_VBO;
-		std::unique_ptr<Shader> m_Shader;
+		std::shared_ptr<Shader> m_Shader;
 		//std::unique_ptr<Texture> m_Texture;
 
 		glm::mat4 m_Proj, m_View;
@@ -45,6 +46,11 @@ namespace test
 		float m_QuadPosition5[2] = { 430.0f, -50.0f };
 		int m_QuadCount = 2;
 
-		GLuint m_Tex1, m_Tex2, m_Tex3, m_Tex4, m_Tex5;
+		std::shared_ptr<Texture> m_Tex1, m_Tex2, m_Tex3, m_Tex4, m_Tex5;
+
+		//	When the test was made, to measure how long until its first frame and until every texture is in.
+		std::chrono::steady_clock::time_point m_CreatedAt;
+		double m_TimeToFirstFrame = -1.0;
+		double m_TimeToLoaded = -1.0;
 	};
 }
\ No newline at end of file
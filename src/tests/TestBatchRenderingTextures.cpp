@@ -1,40 +1,18 @@
 #include <iostream>
 #include "TestBatchRenderingTextures.h"
 
-#include "stb_image/stb_image.h"
+#include "AssetManager.h"
+#include "FrameUniforms.h"
 
-static GLuint LoadTexture(const std::string& path)
-{
-    int w, h, bits;
-
-    stbi_set_flip_vertically_on_load(1);
-    //  For last parameter, could use STBI_rgb -> 3
-    auto* pixels = stbi_load(path.c_str(), &w, &h, &bits, 4);
-    GLuint textureID;
-
-    GLCall(glCreateTextures(GL_TEXTURE_2D, 1, &textureID));
-    GLCall(glBindTexture(GL_TEXTURE_2D, textureID));
-
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+#include "GLStateCache.h"
 
-    //  So for this, would use GL_RGBA8
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-
-    stbi_image_free(pixels);
-
-    return textureID;
-    
-}
 namespace test
 {
 
     TestBatchRenderingTextures::TestBatchRenderingTextures()
         : m_Name{ "Batch Rendering Test - Textures" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
         m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f))),
-        m_TranslationA(200, 200, 0)//, m_TranslationB(400, 200, 0)
+        m_TranslationA(200, 200, 0), m_CreatedAt(std::chrono::steady_clock::now())//, m_TranslationB(400, 200, 0)
     {
         
 
@@ -99,7 +77,7 @@ namespace test
 
         /**
         *   Displays the three quads, using the 'vertices' vertex data
-        *   and the normal 'BasicBatch-Textures.shader'
+        *   and the Batch.shader variant with one texture
         *   in the way below:
         */
         /*
@@ -112,7 +90,7 @@ namespace test
 
             m_IBO = std::make_unique<IndexBuffer>(indices, 18);
 
-            m_Shader = std::make_unique<Shader>("res/shaders/ep28/BasicBatch-Textures.shader");
+            m_Shader = AssetManager::Get().GetShaderVariant("res/shaders/Batch/Batch.shader", { "VERTEX_COLOR", "TEXTURED", "MODEL_MATRIX" });
         */
         
         m_VBO = std::make_unique<VertexBuffer>(vertices, sizeof(vertices));
@@ -125,23 +103,24 @@ namespace test
 
         m_IBO = std::make_unique<IndexBuffer>(indices, 18);
 
-        m_Shader = std::make_unique<Shader>("res/shaders/ep28/BasicBatch-Textures_v2.shader");
+        //  The sampler array as big as the GPU allows, rather than a fixed size.
+        m_Shader = AssetManager::Get().GetShaderVariant("res/shaders/Batch/Batch.shader", { "VERTEX_COLOR", "TEXTURED", "MAX_TEXTURES=" + std::to_string(Shader::GetMaxTextureUnits()), "MODEL_MATRIX" });
         
         m_Shader->Bind();
 
         //  Loading Textures
 
-        m_Tex1 = LoadTexture("res/textures/morning glory.jpg");
-        m_Tex2 = LoadTexture("res/textures/T-REX.png");
-        m_Tex3 = LoadTexture("res/textures/red_diamond_heart.png");
+        m_Tex1 = AssetManager::Get().GetTexture("res/textures/morning glory.jpg", TextureLoad::Async);
+        m_Tex2 = AssetManager::Get().GetTexture("res/textures/T-REX.png", TextureLoad::Async);
+        m_Tex3 = AssetManager::Get().GetTexture("res/textures/red_diamond_heart.png", TextureLoad::Async);
 
         //int samplers[] = { (int)m_MorningGloryTex, (int)m_RasenganTex, (int)m_DaisyTex };
         int samplers[] = { 0, 1, 2 };
-        m_Shader->SetUniform1iv("u_Textures", samplers);
+        m_Shader->SetUniform1iv("u_Textures", 3, samplers);
 
-        std::cout << "Tex1: " << (unsigned int)m_Tex1 << '\n';
-        std::cout << "Tex2: " << (unsigned int)m_Tex2 << '\n';
-        std::cout << "Tex3: " << (unsigned int)m_Tex3 << '\n';
+        std::cout << "Tex1: " << m_Tex1->GetRendererID() << '\n';
+        std::cout << "Tex2: " << m_Tex2->GetRendererID() << '\n';
+        std::cout << "Tex3: " << m_Tex3->GetRendererID() << '\n';
     }
 
     TestBatchRenderingTextures::~TestBatchRenderingTextures()
@@ -155,6 +134,16 @@ namespace test
 
     void TestBatchRenderingTextures::OnRender()
     {
+        //  With TextureLoad::Async the first frame comes before the textures do, which show grey until then.
+        auto now = std::chrono::steady_clock::now();
+        if (m_TimeToFirstFrame < 0.0)
+        {
+            m_TimeToFirstFrame = std::chrono::duration<double, std::milli>(now - m_CreatedAt).count();
+            std::cout << "Time to first frame: " << m_TimeToFirstFrame << " ms\n";
+        }
+        if (m_TimeToLoaded < 0.0 && m_Tex1->IsLoaded() && m_Tex2->IsLoaded() && m_Tex3->IsLoaded())
+            m_TimeToLoaded = std::chrono::duration<double, std::milli>(now - m_CreatedAt).count();
+
         GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
         GLCall(glClear(GL_COLOR_BUFFER_BIT));
 
@@ -166,17 +155,18 @@ namespace test
         //  setup uniform
         //shader.SetUniform4f("u_Color", r, 0.05f, 0.58f, 1.0f);
         glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-        glm::mat4 mvp = m_Proj * m_View * model;
+        //  The camera goes to the Frame block once; the draw only has its model matrix.
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
 
-        //  Specifying different MVP matrix to render more than one models
+        //  Specifying different model matrix to render more than one models
         m_Shader->Bind();
         //  These indices here, the first arguments are the Textures'IDs
         //  They should correspond to the Texture ID in the Vertex Data.
-        glBindTextureUnit(0, m_Tex1);
-        glBindTextureUnit(1, m_Tex2);
-        glBindTextureUnit(2, m_Tex3);
+        GLStateCache::Get().BindTextureUnit(0, m_Tex1->GetRendererID());
+        GLStateCache::Get().BindTextureUnit(1, m_Tex2->GetRendererID());
+        GLStateCache::Get().BindTextureUnit(2, m_Tex3->GetRendererID());
 
-        m_Shader->SetUniformMat4("u_MVP", mvp);
+        m_Shader->SetUniformMat4("u_Model", model);
         //  the Renderer Binds the VAO and IBO and the Shader
         renderer.Draw(*m_VAO, *m_IBO, *m_Shader);
 
@@ -190,6 +180,11 @@ namespace test
         ImGui::SliderFloat("y_slider_B", &m_TranslationB.y, 0.0f, 540.0f);*/
 
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+        ImGui::Text("Time to first frame: %.1f ms", m_TimeToFirstFrame);
+        if (m_TimeToLoaded >= 0.0)
+            ImGui::Text("All textures loaded after %.1f ms", m_TimeToLoaded);
+        else
+            ImGui::Text("Textures loading...");
 
     }
 }
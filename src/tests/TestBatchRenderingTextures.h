@@ -2,12 +2,13 @@
 #pragma once
 
 #include <memory>
+#include <chrono>
 
 #include "Test.h"
 
 #include "Renderer.h"
 #include "imgui/imgui.h"
-//#include "Texture.h"
+#include "Texture.h"
 #include "VertexBufferLayout.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -33,12 +34,17 @@ namespace test
 		std::unique_ptr<VertexArray> m_VAO;
 		std::unique_ptr<IndexBuffer> m_IBO;
 		std::unique_ptr<VertexBuffer> m_VBO;
-		std::unique_ptr<Shader> m_Shader;
+		std::shared_ptr<Shader> m_Shader;
 		//std::unique_ptr<Texture> m_Texture;
 
 		glm::mat4 m_Proj, m_View;
 		glm::vec3 m_TranslationA;//, m_TranslationB;
 
-		GLuint m_Tex1, m_Tex2, m_Tex3;
+		std::shared_ptr<Texture> m_Tex1, m_Tex2, m_Tex3;
+
+		//	When the test was made, to measure how long until its first frame and until every texture is in.
+		std::chrono::steady_clock::time_point m_CreatedAt;
+		double m_TimeToFirstFrame = -1.0;
+		double m_TimeToLoaded = -1.0;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <chrono>
+
+#include "TestDrawQueue.h"
+
+#include "AssetManager.h"
+
+
+namespace test
+{
+
+    TestDrawQueue::TestDrawQueue()
+        : m_Name{ "Draw Queue Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        float quad[] = {
+            -0.5f, -0.5f, 0.0f, 0.0f,   //  0
+             0.5f, -0.5f, 1.0f, 0.0f,   //  1
+             0.5f,  0.5f, 1.0f, 1.0f,   //  2
+            -0.5f,  0.5f, 0.0f, 1.0f    //  3
+        };
+
+        float diamond[] = {
+             0.0f, -0.5f, 0.5f, 0.0f,   //  0
+             0.5f,  0.0f, 1.0f, 0.5f,   //  1
+             0.0f,  0.5f, 0.5f, 1.0f,   //  2
+            -0.5f,  0.0f, 0.0f, 0.5f    //  3
+        };
+
+        unsigned int indices[] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        VertexBufferLayout layout;
+        layout.Push<float>(2u);
+        layout.Push<float>(2u);
+
+        m_QuadVAO = std::make_unique<VertexArray>();
+        m_QuadVBO = std::make_unique<VertexBuffer>(quad, 16 * sizeof(float));
+        m_QuadVAO->AddBuffer(*m_QuadVBO, layout);
+
+        m_DiamondVAO = std::make_unique<VertexArray>();
+        m_DiamondVBO = std::make_unique<VertexBuffer>(diamond, 16 * sizeof(float));
+        m_DiamondVAO->AddBuffer(*m_DiamondVBO, layout);
+
+        //  Both vertex arrays use the same indices; the renderer binds it with each of them.
+        m_IBO = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_BasicShader = AssetManager::Get().GetShader("res/shaders/ep20/Basic.shader", ShaderLoad::Async);
+        m_BasicShader->Bind();
+        m_BasicShader->SetUniform1i("u_Texture", 0);
+
+        m_TintedShader = AssetManager::Get().GetShader("res/shaders/DrawQueue/Tinted.shader", ShaderLoad::Async);
+        m_TintedShader->Bind();
+        m_TintedShader->SetUniform1i("u_Texture", 0);
+
+        m_Textures[0] = AssetManager::Get().GetTexture("res/textures/star_rasengan.png");
+        m_Textures[1] = AssetManager::Get().GetTexture("res/textures/T-REX.png");
+        m_Textures[2] = AssetManager::Get().GetTexture("res/textures/red_diamond_heart.png");
+    }
+
+    TestDrawQueue::~TestDrawQueue()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestDrawQueue::OnUpdate(float deltaTime)
+    {
+    }
+
+    void TestDrawQueue::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer.SetMode(m_Mode == 1 ? RenderMode::Sorted : RenderMode::Immediate);
+        m_Renderer.ResetQueueStats();
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        const glm::mat4 viewProjection = m_Proj * m_View;
+        const float step = m_ObjectSize * 1.25f;
+        const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+        for (int i = 0; i < m_ObjectCount; i++)
+        {
+            float x = (i % columns) * step + step * 0.5f;
+            float y = (float)((int)((i / columns) * step) % 540) + step * 0.5f;
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
+            model = glm::scale(model, glm::vec3(m_ObjectSize, m_ObjectSize, 1.0f));
+
+            //  Each neighbour differs in shader, texture or vertex array.
+            Shader& shader = (i % 2 == 0) ? *m_BasicShader : *m_TintedShader;
+            unsigned int texture = m_Textures[i % 3]->GetRendererID();
+            const VertexArray& vao = ((i / 2) % 2 == 0) ? *m_QuadVAO : *m_DiamondVAO;
+
+            m_Renderer.Submit(vao, *m_IBO, shader, viewProjection * model, &texture, 1);
+        }
+
+        m_Renderer.Execute();
+
+        auto end = std::chrono::high_resolution_clock::now();
+        m_SubmitTime = std::chrono::duration<double, std::milli>(end - start).count();
+        m_LastStats = m_Renderer.GetQueueStats();
+    }
+
+    void TestDrawQueue::OnImGuiRender()
+    {
+        ImGui::SliderInt("Object Count", &m_ObjectCount, 0, 20000);
+        ImGui::SliderFloat("Object Size", &m_ObjectSize, 2.0f, 100.0f);
+
+        ImGui::RadioButton("Immediate", &m_Mode, 0); ImGui::SameLine();
+        ImGui::RadioButton("Sorted", &m_Mode, 1);
+
+        ImGui::Text("Commands: %u", m_LastStats.Commands);
+        ImGui::Text("Shader Changes: %u", m_LastStats.ShaderChanges);
+        ImGui::Text("Texture Changes: %u", m_LastStats.TextureChanges);
+        ImGui::Text("Vertex Array Changes: %u", m_LastStats.VertexArrayChanges);
+        ImGui::Text("Uniform Uploads: %u", m_LastStats.UniformUploads);
+        ImGui::Text("Submit + Execute: %.3f ms", m_SubmitTime);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
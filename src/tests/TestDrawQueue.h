@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "imgui/imgui.h"
+#include "Texture.h"
+#include "VertexBufferLayout.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Draws a grid of objects where every object uses a different shader, texture or vertex array than the one
+	*	before it, which is the worst order for the GPU's state.
+	*	The objects go through Renderer::Submit(), and the mode can be switched between immediate and sorted
+	*	to compare how many state changes each one makes.
+	*/
+	class TestDrawQueue : public Test
+	{
+	public:
+		TestDrawQueue();
+		~TestDrawQueue();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+
+		const char* m_Name;
+
+		Renderer m_Renderer;
+
+		std::unique_ptr<VertexArray> m_QuadVAO;
+		std::unique_ptr<VertexBuffer> m_QuadVBO;
+		std::unique_ptr<VertexArray> m_DiamondVAO;
+		std::unique_ptr<VertexBuffer> m_DiamondVBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::shared_ptr<Shader> m_BasicShader;
+		std::shared_ptr<Shader> m_TintedShader;
+		std::shared_ptr<Texture> m_Textures[3];
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_ObjectCount = 1000;
+		float m_ObjectSize = 12.0f;
+		//	Radio button value; 0 is RenderMode::Immediate, 1 is RenderMode::Sorted.
+		int m_Mode = 1;
+
+		Renderer::QueueStats m_LastStats;
+		//	How long submitting and executing took on the CPU last frame, in milliseconds.
+		double m_SubmitTime = 0.0;
+	};
+}
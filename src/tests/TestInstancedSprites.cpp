@@ -0,0 +1,112 @@
+#include <iostream>
+
+#include "TestInstancedSprites.h"
+
+#include "AssetManager.h"
+#include "FrameUniforms.h"
+
+
+namespace test
+{
+
+    TestInstancedSprites::TestInstancedSprites()
+        : m_Name{ "Instanced Sprites Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        float positions[] = {
+            -0.5f, -0.5f, 0.0f, 0.0f,   //  0
+             0.5f, -0.5f, 1.0f, 0.0f,   //  1
+             0.5f,  0.5f, 1.0f, 1.0f,   //  2
+            -0.5f,  0.5f, 0.0f, 1.0f    //  3
+        };
+
+        unsigned int indices[] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        m_VAO = std::make_unique<VertexArray>();
+
+        //  Per vertex: locations 0 and 1.
+        m_QuadVBO = std::make_unique<VertexBuffer>(positions, 16 * sizeof(float));
+        VertexBufferLayout quadLayout;
+        quadLayout.Push<float>(2u);
+        quadLayout.Push<float>(2u);
+        m_VAO->AddBuffer(*m_QuadVBO, quadLayout);
+
+        //  Per instance, where Batch.shader's INSTANCED variant has them: the transform takes locations 4 to 7,
+        //  then the color 8 and the uv rect 9.
+        m_InstanceVBO = std::make_unique<VertexBuffer>(nullptr, MaxSprites * (unsigned int)sizeof(SpriteInstance), false);
+        VertexBufferLayout instanceLayout;
+        instanceLayout.Push<float>(16u);
+        instanceLayout.Push<float>(4u);
+        instanceLayout.Push<float>(4u);
+        instanceLayout.SetDivisor(1);
+        m_VAO->AddBuffer(*m_InstanceVBO, instanceLayout, 4);
+
+        m_IBO = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = AssetManager::Get().GetShaderVariant("res/shaders/Batch/Batch.shader", { "TEXTURED", "INSTANCED", "TINT" });
+        m_Shader->Bind();
+        m_Shader->SetUniform1i("u_Texture", 0);
+        m_Texture = AssetManager::Get().GetTexture("res/textures/star_rasengan.png");
+
+        m_Instances.reserve(MaxSprites);
+    }
+
+    TestInstancedSprites::~TestInstancedSprites()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestInstancedSprites::OnUpdate(float deltaTime)
+    {
+    }
+
+    void TestInstancedSprites::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        const float step = m_SpriteSize * 1.25f;
+        const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+
+        m_Instances.clear();
+        for (int i = 0; i < m_SpriteCount; i++)
+        {
+            float x = (i % columns) * step + step * 0.5f;
+            float y = (float)((int)((i / columns) * step) % 540) + step * 0.5f;
+
+            SpriteInstance instance;
+            instance.Transform = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
+            instance.Transform = glm::rotate(instance.Transform, glm::radians(m_Rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+            instance.Transform = glm::scale(instance.Transform, glm::vec3(m_SpriteSize, m_SpriteSize, 1.0f));
+            instance.Color = glm::vec4(x / 960.0f, y / 540.0f, 0.6f, 1.0f);
+            //  Every sprite shows one quarter of the texture, going round the four of them.
+            instance.UVRect = glm::vec4((i % 2) * 0.5f, ((i / 2) % 2) * 0.5f, 0.5f, 0.5f);
+            m_Instances.push_back(instance);
+        }
+
+        m_InstanceVBO->SetData(m_Instances.data(), (unsigned int)(m_Instances.size() * sizeof(SpriteInstance)));
+
+        m_Texture->Bind();
+        //  Each instance has its own transform; the camera is the frame's.
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
+        m_Shader->Bind();
+
+        Renderer renderer;
+        renderer.DrawInstanced(*m_VAO, *m_IBO, *m_Shader, (unsigned int)m_Instances.size());
+    }
+
+    void TestInstancedSprites::OnImGuiRender()
+    {
+        ImGui::SliderInt("Sprite Count", &m_SpriteCount, 0, (int)MaxSprites);
+        ImGui::SliderFloat("Sprite Size", &m_SpriteSize, 1.0f, 100.0f);
+        ImGui::SliderFloat("Rotation", &m_Rotation, 0.0f, 360.0f);
+
+        ImGui::Text("Draw Calls: %u", m_SpriteCount > 0 ? 1u : 0u);
+        ImGui::Text("Instance Data: %.2f KB", m_SpriteCount * sizeof(SpriteInstance) / 1024.0);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
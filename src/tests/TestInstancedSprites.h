@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "imgui/imgui.h"
+#include "Texture.h"
+#include "VertexBufferLayout.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Draws many copies of the same quad with one glDrawElementsInstanced.
+	*	The quad's 4 vertices are in one buffer, and everything that differs between the copies
+	*	(transform, color, which part of the texture) is in a second, per-instance buffer.
+	*/
+	class TestInstancedSprites : public Test
+	{
+	public:
+		TestInstancedSprites();
+		~TestInstancedSprites();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		//	Must match the per-instance layout and the attributes in the shader.
+		struct SpriteInstance
+		{
+			glm::mat4 Transform;
+			glm::vec4 Color;
+			glm::vec4 UVRect;
+		};
+
+		static const unsigned int MaxSprites = 100000;
+
+		const char* m_Name;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_QuadVBO;
+		std::unique_ptr<VertexBuffer> m_InstanceVBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::shared_ptr<Shader> m_Shader;
+		std::shared_ptr<Texture> m_Texture;
+
+		std::vector<SpriteInstance> m_Instances;
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_SpriteCount = 10000;
+		float m_SpriteSize = 6.0f;
+		float m_Rotation = 0.0f;
+	};
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+
+#include "TestMultiDrawIndirect.h"
+
+#include "AssetManager.h"
+#include "GLStateCache.h"
+
+
+namespace test
+{
+
+    TestMultiDrawIndirect::TestMultiDrawIndirect()
+        : m_Name{ "Multi-Draw Indirect Test" }, m_Indirect(IndirectDrawBuffer::IsSupported()),
+        m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        //  Three meshes one after the other: a quad, a diamond and a triangle.
+        float vertices[] = {
+            -0.5f, -0.5f, 0.0f, 0.0f,   //  quad 0
+             0.5f, -0.5f, 1.0f, 0.0f,   //  quad 1
+             0.5f,  0.5f, 1.0f, 1.0f,   //  quad 2
+            -0.5f,  0.5f, 0.0f, 1.0f,   //  quad 3
+
+             0.0f, -0.5f, 0.5f, 0.0f,   //  diamond 0
+             0.5f,  0.0f, 1.0f, 0.5f,   //  diamond 1
+             0.0f,  0.5f, 0.5f, 1.0f,   //  diamond 2
+            -0.5f,  0.0f, 0.0f, 0.5f,   //  diamond 3
+
+            -0.5f, -0.5f, 0.0f, 0.0f,   //  triangle 0
+             0.5f, -0.5f, 1.0f, 0.0f,   //  triangle 1
+             0.0f,  0.5f, 0.5f, 1.0f    //  triangle 2
+        };
+
+        //  Each mesh's indices start from 0; the base vertex moves them to where the mesh's vertices are.
+        unsigned int indices[] = {
+            0, 1, 2, 2, 3, 0,           //  quad
+            0, 1, 2, 2, 3, 0,           //  diamond
+            0, 1, 2                     //  triangle
+        };
+
+        m_Meshes[0] = { 0, 6, 0 };
+        m_Meshes[1] = { 6, 6, 4 };
+        m_Meshes[2] = { 12, 3, 8 };
+
+        m_VAO = std::make_unique<VertexArray>();
+        m_VBO = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+        VertexBufferLayout layout;
+        layout.Push<float>(2u);
+        layout.Push<float>(2u);
+        m_VAO->AddBuffer(*m_VBO, layout);
+
+        m_IBO = std::make_unique<IndexBuffer>(indices, 15);
+
+        //  The shader has to match the path Renderer::DrawIndirect() is going to take.
+        if (m_Indirect)
+            m_Shader = AssetManager::Get().GetShader("res/shaders/Indirect/MultiDraw.shader");
+        else
+            m_Shader = AssetManager::Get().GetShader("res/shaders/Indirect/MultiDrawFallback.shader");
+
+        int samplers[4] = { 0, 1, 2, 3 };
+        m_Shader->Bind();
+        m_Shader->SetUniform1iv("u_Textures", 4, samplers);
+
+        m_Textures[0] = AssetManager::Get().GetTexture("res/textures/star_rasengan.png");
+        m_Textures[1] = AssetManager::Get().GetTexture("res/textures/T-REX.png");
+        m_Textures[2] = AssetManager::Get().GetTexture("res/textures/red_diamond_heart.png");
+        m_Textures[3] = AssetManager::Get().GetTexture("res/textures/shark.jpg");
+
+        m_Draws = std::make_unique<IndirectDrawBuffer>(MaxObjects);
+    }
+
+    TestMultiDrawIndirect::~TestMultiDrawIndirect()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestMultiDrawIndirect::OnUpdate(float deltaTime)
+    {
+    }
+
+    void TestMultiDrawIndirect::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        const glm::mat4 viewProjection = m_Proj * m_View;
+        const float step = m_ObjectSize * 1.25f;
+        const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+
+        m_Draws->Clear();
+        for (int i = 0; i < m_ObjectCount; i++)
+        {
+            float x = (i % columns) * step + step * 0.5f;
+            float y = (float)((int)((i / columns) * step) % 540) + step * 0.5f;
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
+            model = glm::scale(model, glm::vec3(m_ObjectSize, m_ObjectSize, 1.0f));
+
+            const Mesh& mesh = m_Meshes[i % 3];
+            m_Draws->Add(mesh.IndexCount, mesh.FirstIndex, mesh.BaseVertex, viewProjection * model, i % 4);
+        }
+        m_Draws->Upload();
+
+        for (unsigned int i = 0; i < 4; i++)
+            GLStateCache::Get().BindTextureUnit(i, m_Textures[i]->GetRendererID());
+
+        Renderer renderer;
+        m_DrawCalls = renderer.DrawIndirect(*m_VAO, *m_IBO, *m_Shader, *m_Draws);
+    }
+
+    void TestMultiDrawIndirect::OnImGuiRender()
+    {
+        ImGui::SliderInt("Object Count", &m_ObjectCount, 0, (int)MaxObjects);
+        ImGui::SliderFloat("Object Size", &m_ObjectSize, 2.0f, 100.0f);
+
+        ImGui::Text("Path: %s", m_Indirect ? "glMultiDrawElementsIndirect + gl_DrawID" : "one draw per object (no multi-draw indirect)");
+        ImGui::Text("Objects: %u", m_Draws->GetDrawCount());
+        ImGui::Text("Draw Calls: %u", m_DrawCalls);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
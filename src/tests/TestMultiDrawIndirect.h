@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "IndirectDrawBuffer.h"
+#include "imgui/imgui.h"
+#include "Texture.h"
+#include "VertexBufferLayout.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Draws many objects made of a few different meshes, all packed in one vertex buffer and one index buffer,
+	*	with Renderer::DrawIndirect(): one glMultiDrawElementsIndirect for all of them where the context allows it,
+	*	and a draw call per object where it doesn't.
+	*/
+	class TestMultiDrawIndirect : public Test
+	{
+	public:
+		TestMultiDrawIndirect();
+		~TestMultiDrawIndirect();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		//	Where a mesh is inside the shared buffers.
+		struct Mesh
+		{
+			unsigned int FirstIndex;
+			unsigned int IndexCount;
+			int BaseVertex;
+		};
+
+		static const unsigned int MaxObjects = 4096;
+
+		const char* m_Name;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VBO;
+		std::unique_ptr<IndexBuffer> m_IBO;
+		std::shared_ptr<Shader> m_Shader;
+		std::unique_ptr<IndirectDrawBuffer> m_Draws;
+		std::shared_ptr<Texture> m_Textures[4];
+		Mesh m_Meshes[3];
+
+		bool m_Indirect;
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_ObjectCount = 500;
+		float m_ObjectSize = 16.0f;
+		unsigned int m_DrawCalls = 0;
+	};
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <chrono>
+
+#include "TestParallelSprites.h"
+
+#include "AssetManager.h"
+#include "JobSystem.h"
+#include "FrameUniforms.h"
+
+
+namespace test
+{
+
+    TestParallelSprites::TestParallelSprites()
+        : m_Name{ "Parallel Sprites Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        m_Renderer2D = std::make_unique<Renderer2D>();
+
+        m_Texture1 = AssetManager::Get().GetTexture("res/textures/star_rasengan.png");
+        m_Texture2 = AssetManager::Get().GetTexture("res/textures/T-REX.png");
+    }
+
+    TestParallelSprites::~TestParallelSprites()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestParallelSprites::BuildSprites()
+    {
+        m_Sprites.resize(m_SpriteCount);
+
+        const float step = m_SpriteSize * 1.25f;
+        const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+        for (int i = 0; i < m_SpriteCount; i++)
+        {
+            float x = (i % columns) * step;
+            float y = (float)((int)((i / columns) * step) % 540);
+
+            Sprite& sprite = m_Sprites[i];
+            sprite.Position = glm::vec3(x, y, 0.0f);
+            sprite.Size = glm::vec2(m_SpriteSize, m_SpriteSize);
+            sprite.Color = glm::vec4(x / 960.0f, y / 540.0f, 0.6f, 1.0f);
+            //  A third of them colored, the rest alternating between the two textures.
+            if (i % 3 == 1)
+                sprite.TextureID = m_Texture1->GetRendererID();
+            else if (i % 3 == 2)
+                sprite.TextureID = m_Texture2->GetRendererID();
+            else
+                sprite.TextureID = 0;
+        }
+
+        m_BuiltCount = m_SpriteCount;
+        m_BuiltSize = m_SpriteSize;
+    }
+
+    void TestParallelSprites::OnUpdate(float deltaTime)
+    {
+        if (m_BuiltCount != m_SpriteCount || m_BuiltSize != m_SpriteSize)
+            BuildSprites();
+    }
+
+    void TestParallelSprites::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer2D->ResetStats();
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
+        m_Renderer2D->BeginBatch();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        if (m_Parallel)
+            m_Renderer2D->DrawQuads(m_Sprites);
+        else
+        {
+            for (const Sprite& sprite : m_Sprites)
+            {
+                if (sprite.TextureID)
+                    m_Renderer2D->DrawQuad(sprite.Position, sprite.Size, sprite.TextureID, sprite.Color);
+                else
+                    m_Renderer2D->DrawQuad(sprite.Position, sprite.Size, sprite.Color);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        m_BuildTime = std::chrono::duration<double, std::milli>(end - start).count();
+
+        m_Renderer2D->EndBatch();
+    }
+
+    void TestParallelSprites::OnImGuiRender()
+    {
+        ImGui::SliderInt("Sprite Count", &m_SpriteCount, 0, MaxSprites);
+        ImGui::SliderFloat("Sprite Size", &m_SpriteSize, 1.0f, 20.0f);
+        ImGui::Checkbox("Parallel (DrawQuads)", &m_Parallel);
+
+        const Renderer2D::Stats& stats = m_Renderer2D->GetStats();
+        ImGui::Text("Threads: %u", m_Parallel ? JobSystem::Get().GetThreadCount() : 1u);
+        ImGui::Text("Vertex Generation: %.3f ms", m_BuildTime);
+        ImGui::Text("Draw Calls: %u", stats.DrawCalls);
+        ImGui::Text("Quads: %u", stats.QuadCount);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
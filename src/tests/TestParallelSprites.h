@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer2D.h"
+#include "imgui/imgui.h"
+#include "Texture.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Draws up to 500000 sprites through the Renderer2D, either one DrawQuad() at a time on the render thread,
+	*	or with DrawQuads(), which writes the vertices on every thread of the JobSystem.
+	*/
+	class TestParallelSprites : public Test
+	{
+	public:
+		TestParallelSprites();
+		~TestParallelSprites();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		//	Lays the sprites out again when the count or size changes.
+		void BuildSprites();
+
+	private:
+		static const int MaxSprites = 500000;
+
+		const char* m_Name;
+
+		std::unique_ptr<Renderer2D> m_Renderer2D;
+		std::shared_ptr<Texture> m_Texture1;
+		std::shared_ptr<Texture> m_Texture2;
+
+		std::vector<Sprite> m_Sprites;
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_SpriteCount = 200000;
+		float m_SpriteSize = 2.0f;
+		bool m_Parallel = true;
+		//	What the sprites were last built with.
+		int m_BuiltCount = -1;
+		float m_BuiltSize = 0.0f;
+
+		//	CPU time of writing all the sprites last frame, in milliseconds.
+		double m_BuildTime = 0.0;
+	};
+}
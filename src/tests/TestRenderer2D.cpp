@@ -0,0 +1,130 @@
+#include <iostream>
+
+#include "TestRenderer2D.h"
+
+#include "AssetManager.h"
+#include "FrameUniforms.h"
+
+#include "GLStateCache.h"
+#include "BindlessTextures.h"
+
+
+namespace test
+{
+
+    TestRenderer2D::TestRenderer2D()
+        : m_Name{ "Renderer2D Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f))),
+        m_Translation(0, 0, 0)
+    {
+        m_Renderer2D = std::make_unique<Renderer2D>();
+
+        m_Texture1 = AssetManager::Get().GetTexture("res/textures/star_rasengan.png");
+        m_Texture2 = AssetManager::Get().GetTexture("res/textures/T-REX.png");
+
+        m_Bindless = m_Renderer2D->GetTextureMode() == Renderer2D::TextureMode::Bindless;
+    }
+
+    TestRenderer2D::~TestRenderer2D()
+    {
+        for (unsigned int texture : m_ColorTextures)
+        {
+            BindlessTextures::Release(texture);
+            GLStateCache::Get().OnDeleteTexture(texture);
+        }
+        GLCall(glDeleteTextures((int)m_ColorTextures.size(), m_ColorTextures.data()));
+
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestRenderer2D::OnUpdate(float deltaTime)
+    {
+        //  Made as they're asked for and kept after, so the slider can go back and forth.
+        while ((int)m_ColorTextures.size() < m_TextureCount - 2)
+        {
+            unsigned int index = (unsigned int)m_ColorTextures.size();
+            unsigned int color = 0xff000000 | ((index * 97) % 256) << 16 | ((index * 53) % 256) << 8 | ((index * 199) % 256);
+
+            unsigned int texture = 0;
+            GLCall(glGenTextures(1, &texture));
+            GLStateCache::Get().BindTexture(GL_TEXTURE_2D, texture);
+            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &color));
+            GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
+            m_ColorTextures.push_back(texture);
+        }
+    }
+
+    void TestRenderer2D::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        glm::mat4 view = glm::translate(m_View, m_Translation);
+
+        m_Renderer2D->SetTextureMode(m_Bindless ? Renderer2D::TextureMode::Bindless : Renderer2D::TextureMode::Slots);
+        m_Renderer2D->ResetStats();
+        FrameUniforms::Get().SetCamera(view, m_Proj);
+        m_Renderer2D->BeginBatch();
+
+        //  Lays the quads out in rows across the window, wrapping back to the bottom when it's full.
+        const float step = m_QuadSize * 1.25f;
+        const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+        for (int i = 0; i < m_QuadCount; i++)
+        {
+            float x = (i % columns) * step;
+            float y = (float)((int)((i / columns) * step) % 540);
+            glm::vec2 position(x, y);
+            glm::vec2 size(m_QuadSize, m_QuadSize);
+
+            if (m_Textured && m_TextureCount > 2)
+            {
+                int texture = i % m_TextureCount;
+                if (texture == 0)
+                    m_Renderer2D->DrawQuad(position, size, *m_Texture1);
+                else if (texture == 1)
+                    m_Renderer2D->DrawQuad(position, size, *m_Texture2);
+                else
+                    m_Renderer2D->DrawQuad(glm::vec3(position, 0.0f), size, m_ColorTextures[texture - 2]);
+            }
+            else if (m_Textured && i % 3 == 1)
+                m_Renderer2D->DrawQuad(position, size, *m_Texture1);
+            else if (m_Textured && i % 3 == 2)
+                m_Renderer2D->DrawQuad(position, size, *m_Texture2);
+            else
+                m_Renderer2D->DrawQuad(position, size, glm::vec4(x / 960.0f, y / 540.0f, 0.6f, 1.0f));
+        }
+
+        m_Renderer2D->EndBatch();
+    }
+
+    void TestRenderer2D::OnImGuiRender()
+    {
+        ImGui::SliderFloat("x_slider", &m_Translation.x, -960.0f, 960.0f);
+        ImGui::SliderFloat("y_slider", &m_Translation.y, -540.0f, 540.0f);
+
+        ImGui::SliderInt("Quad Count", &m_QuadCount, 0, 100000);
+        ImGui::SliderFloat("Quad Size", &m_QuadSize, 1.0f, 100.0f);
+        ImGui::Checkbox("Textured", &m_Textured);
+        ImGui::SliderInt("Textures", &m_TextureCount, 2, 256);
+
+        if (BindlessTextures::IsSupported())
+            ImGui::Checkbox("Bindless", &m_Bindless);
+        ImGui::Text("Texture path: %s%s", m_Renderer2D->GetTextureModeName(), BindlessTextures::IsSupported() ? "" : " (no bindless support)");
+
+        const Renderer2D::Stats& stats = m_Renderer2D->GetStats();
+        ImGui::Text("Draw Calls: %u", stats.DrawCalls);
+        ImGui::Text("Quads: %u", stats.QuadCount);
+        ImGui::Text("Vertices: %u", stats.GetVertexCount());
+        ImGui::Text("Indices: %u", stats.GetIndexCount());
+
+        const StreamingVertexBuffer& vertexBuffer = m_Renderer2D->GetVertexBuffer();
+        const StreamingVertexBuffer::Stats& streamStats = vertexBuffer.GetStats();
+        ImGui::Text("Vertex Buffer: %s", vertexBuffer.IsPersistent() ? "persistent mapped" : "orphaning");
+        ImGui::Text("Bytes Written: %.2f KB", streamStats.BytesWritten / 1024.0);
+        ImGui::Text("Fence Waits: %u (%.3f ms)", streamStats.FenceWaits, streamStats.FenceWaitTime);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
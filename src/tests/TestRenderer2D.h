@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer2D.h"
+#include "imgui/imgui.h"
+#include "Texture.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Draws a grid of quads through the Renderer2D instead of building the vertices by hand.
+	*	The number of quads can go far past what fits in one batch, to show the automatic flushes.
+	*	With more textures than the batch shader has slots, the slot path flushes every time they run out,
+	*	which the bindless path (where supported) doesn't have to.
+	*/
+	class TestRenderer2D : public Test
+	{
+	public:
+		TestRenderer2D();
+		~TestRenderer2D();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+
+		const char* m_Name;
+
+		std::unique_ptr<Renderer2D> m_Renderer2D;
+		std::shared_ptr<Texture> m_Texture1;
+		std::shared_ptr<Texture> m_Texture2;
+
+		glm::mat4 m_Proj, m_View;
+		glm::vec3 m_Translation;
+
+		int m_QuadCount = 1000;
+		float m_QuadSize = 8.0f;
+		bool m_Textured = true;
+		//	How many different textures the quads cycle through; all but the first two are generated, plain colored ones.
+		int m_TextureCount = 2;
+		std::vector<unsigned int> m_ColorTextures;
+		bool m_Bindless;
+	};
+}
@@ -2,6 +2,8 @@
 
 #include "TestTexture2D.h"
 
+#include "AssetManager.h"
+
 
 namespace test
 {
@@ -37,10 +39,10 @@ namespace test
 
         m_IBO = std::make_unique<IndexBuffer>(indices, 6);
        
-        m_Shader = std::make_unique<Shader>("res/shaders/ep20/Basic.shader");
+        m_Shader = AssetManager::Get().GetShader("res/shaders/ep20/Basic.shader");
         m_Shader->Bind();
         m_Shader->SetUniform4f("u_Color", glm::vec4(0.65f, 0.08f, 0.58f, 1.0f));
-        m_Texture = std::make_unique<Texture>("res/textures/star_rasengan.png");
+        m_Texture = AssetManager::Get().GetTexture("res/textures/star_rasengan.png");
 
         //  No need to bind the texture here yet
         m_Shader->SetUniform1i("u_Texture", 0);
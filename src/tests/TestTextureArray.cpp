@@ -0,0 +1,139 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "TestTextureArray.h"
+
+#include "AssetManager.h"
+#include "FrameUniforms.h"
+
+#include "QuadIndexBuffer.h"
+#include "VertexBufferLayout.h"
+
+
+namespace test
+{
+
+    TestTextureArray::TestTextureArray()
+        : m_Name{ "Texture Array Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<StreamingVertexBuffer>((unsigned int)sizeof(QuadVertex), 2 * QuadIndexBuffer::MaxQuads * 4, 3);
+
+        //  The same vertices as Renderer2D; the tex index is the layer here.
+        VertexBufferLayout layout;
+        layout.Push<float>(3u); //  x y z
+        layout.Push<float>(4u); //  r g b a
+        layout.Push<float>(2u); //  u v
+        layout.Push<float>(1u); //  layer
+        m_VAO->AddBuffer(*m_VertexBuffer, layout);
+
+        m_Shader = AssetManager::Get().GetShaderVariant("res/shaders/Batch/Batch.shader", { "VERTEX_COLOR", "TEXTURED", "TEXTURE_ARRAY" });
+        m_Shader->Bind();
+        m_Shader->SetUniform1i("u_Textures", 0);
+
+        m_Textures = std::make_unique<TextureArray>(LayerSize, LayerSize, LayerCount, 0);
+
+        const char* images[] = {
+            "res/textures/T-REX.png",
+            "res/textures/common daisy flower.jpg",
+            "res/textures/morning glory.jpg",
+            "res/textures/osteospermom-voltage yellow_African daisy.jpg",
+            "res/textures/red_diamond_heart.png",
+            "res/textures/shark.jpg",
+            "res/textures/star_rasengan.png",
+            "res/textures/wallpaper_20436.jpg"
+        };
+        const int imageCount = (int)(sizeof(images) / sizeof(images[0]));
+        for (int i = 0; i < imageCount; i++)
+        {
+            if (!m_Textures->LoadLayer(i, images[i]))
+                std::cout << "Couldn't load " << images[i] << '\n';
+        }
+
+        //  The rest are checkerboards, each in its own color, so every layer is visibly different.
+        std::vector<unsigned char> pixels((size_t)LayerSize * LayerSize * 4);
+        for (int layer = imageCount; layer < LayerCount; layer++)
+        {
+            unsigned char r = (unsigned char)(layer * 37), g = (unsigned char)(layer * 91), b = (unsigned char)(layer * 173);
+            int cell = 8 + layer % 4 * 8;
+            for (int y = 0; y < LayerSize; y++)
+            {
+                for (int x = 0; x < LayerSize; x++)
+                {
+                    bool dark = ((x / cell) + (y / cell)) % 2 == 0;
+                    unsigned char* pixel = &pixels[((size_t)y * LayerSize + x) * 4];
+                    pixel[0] = dark ? r / 2 : r;
+                    pixel[1] = dark ? g / 2 : g;
+                    pixel[2] = dark ? b / 2 : b;
+                    pixel[3] = 255;
+                }
+            }
+            m_Textures->SetLayer(layer, pixels.data());
+        }
+        m_Textures->GenerateMipmaps();
+    }
+
+    TestTextureArray::~TestTextureArray()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestTextureArray::OnUpdate(float deltaTime)
+    {
+    }
+
+    void TestTextureArray::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        Renderer renderer;
+        //  The quads are in world space, so nothing is set per draw.
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
+        m_Shader->Bind();
+        //  The only texture bind of the whole frame.
+        m_Textures->Bind(0);
+
+        const float step = m_QuadSize * 1.25f;
+        const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+        const glm::vec4 white(1.0f);
+
+        m_DrawCalls = 0;
+        for (int first = 0; first < m_QuadCount; first += QuadIndexBuffer::MaxQuads)
+        {
+            unsigned int count = (unsigned int)std::min(m_QuadCount - first, (int)QuadIndexBuffer::MaxQuads);
+            QuadVertex* vertices = (QuadVertex*)m_VertexBuffer->Map(count * 4);
+            for (unsigned int q = 0; q < count; q++)
+            {
+                int i = first + (int)q;
+                float x = (i % columns) * step;
+                float y = (float)((int)((i / columns) * step) % 540);
+                float layer = (float)(i % LayerCount);
+
+                QuadVertex* v = &vertices[q * 4];
+                v[0] = { { x,              y,              0.0f }, white, { 0.0f, 0.0f }, layer };
+                v[1] = { { x + m_QuadSize, y,              0.0f }, white, { 1.0f, 0.0f }, layer };
+                v[2] = { { x + m_QuadSize, y + m_QuadSize, 0.0f }, white, { 1.0f, 1.0f }, layer };
+                v[3] = { { x,              y + m_QuadSize, 0.0f }, white, { 0.0f, 1.0f }, layer };
+            }
+            unsigned int baseVertex = m_VertexBuffer->Unmap(count * 4);
+
+            renderer.Draw(*m_VAO, QuadIndexBuffer::Get(), *m_Shader, count * QuadIndexBuffer::IndicesPerQuad, (int)baseVertex);
+            m_DrawCalls++;
+        }
+        m_VertexBuffer->Fence();
+    }
+
+    void TestTextureArray::OnImGuiRender()
+    {
+        ImGui::SliderInt("Quad Count", &m_QuadCount, 0, 100000);
+        ImGui::SliderFloat("Quad Size", &m_QuadSize, 1.0f, 100.0f);
+
+        ImGui::Text("Layers: %d of %dx%d", m_Textures->GetLayerCount(), m_Textures->GetWidth(), m_Textures->GetHeight());
+        ImGui::Text("Draw Calls: %u", m_DrawCalls);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
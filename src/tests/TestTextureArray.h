@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "Renderer2D.h"
+#include "StreamingVertexBuffer.h"
+#include "TextureArray.h"
+#include "imgui/imgui.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Draws quads with a different layer of one GL_TEXTURE_2D_ARRAY each, through the TEXTURE_ARRAY variant of Batch.shader.
+	*	There are far more layers than texture units, yet the whole batch needs one texture bound and one draw call.
+	*	The first layers are the images in res/textures (resized to the layer size), the rest are generated.
+	*/
+	class TestTextureArray : public Test
+	{
+	public:
+		static const int LayerSize = 128;
+		static const int LayerCount = 256;
+
+		TestTextureArray();
+		~TestTextureArray();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+
+		const char* m_Name;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<StreamingVertexBuffer> m_VertexBuffer;
+		std::shared_ptr<Shader> m_Shader;
+		std::unique_ptr<TextureArray> m_Textures;
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_QuadCount = 2000;
+		float m_QuadSize = 16.0f;
+		unsigned int m_DrawCalls = 0;
+	};
+}
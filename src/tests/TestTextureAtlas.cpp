@@ -0,0 +1,119 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#include "TestTextureAtlas.h"
+
+#include "FrameUniforms.h"
+
+
+namespace test
+{
+
+    TestTextureAtlas::TestTextureAtlas()
+        : m_Name{ "Texture Atlas Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        m_Renderer2D = std::make_unique<Renderer2D>();
+
+        m_Paths = {
+            "res/textures/T-REX.png",
+            "res/textures/common daisy flower.jpg",
+            "res/textures/morning glory.jpg",
+            "res/textures/osteospermom-voltage yellow_African daisy.jpg",
+            "res/textures/red_diamond_heart.png",
+            "res/textures/shark.jpg",
+            "res/textures/star_rasengan.png",
+            "res/textures/wallpaper_20436.jpg"
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        m_Atlas = std::make_unique<TextureAtlas>(m_Paths);
+        m_BuildTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        std::cout << "Atlas: " << m_Atlas->GetPageCount() << " pages in " << m_BuildTime << " ms\n";
+
+        BuildSprites();
+    }
+
+    TestTextureAtlas::~TestTextureAtlas()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestTextureAtlas::BuildSprites()
+    {
+        m_Sprites.clear();
+        for (const std::string& path : m_Paths)
+        {
+            if (!m_Atlas->Contains(path))
+                continue;
+
+            const SubTexture& image = m_Atlas->Get(path);
+            glm::vec2 tile = (image.GetMax() - image.GetMin()) / (float)m_Tiles;
+            for (int y = 0; y < m_Tiles; y++)
+            {
+                for (int x = 0; x < m_Tiles; x++)
+                {
+                    glm::vec2 min = image.GetMin() + tile * glm::vec2((float)x, (float)y);
+                    m_Sprites.emplace_back(image.GetTextureID(), min, min + tile, image.GetWidth() / m_Tiles, image.GetHeight() / m_Tiles);
+                }
+            }
+        }
+        m_BuiltTiles = m_Tiles;
+    }
+
+    void TestTextureAtlas::OnUpdate(float deltaTime)
+    {
+        if (m_BuiltTiles != m_Tiles)
+            BuildSprites();
+    }
+
+    void TestTextureAtlas::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer2D->ResetStats();
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
+        m_Renderer2D->BeginBatch();
+
+        if (m_ShowPages)
+        {
+            //  Side by side, as big as fits in the window.
+            float size = std::min(540.0f, 960.0f / std::max(1u, m_Atlas->GetPageCount()));
+            for (unsigned int i = 0; i < m_Atlas->GetPageCount(); i++)
+                m_Renderer2D->DrawQuad(glm::vec3(i * size, 0.0f, 0.0f), glm::vec2(size), m_Atlas->GetPageRendererID(i));
+        }
+        else if (!m_Sprites.empty())
+        {
+            const float step = m_QuadSize * 1.25f;
+            const int columns = (int)(960.0f / step) > 0 ? (int)(960.0f / step) : 1;
+            for (int i = 0; i < m_QuadCount; i++)
+            {
+                float x = (i % columns) * step;
+                float y = (float)((int)((i / columns) * step) % 540);
+                m_Renderer2D->DrawQuad(glm::vec2(x, y), glm::vec2(m_QuadSize), m_Sprites[i % m_Sprites.size()]);
+            }
+        }
+
+        m_Renderer2D->EndBatch();
+    }
+
+    void TestTextureAtlas::OnImGuiRender()
+    {
+        ImGui::SliderInt("Quad Count", &m_QuadCount, 0, 100000);
+        ImGui::SliderFloat("Quad Size", &m_QuadSize, 1.0f, 100.0f);
+        ImGui::SliderInt("Tiles per side", &m_Tiles, 1, 16);
+        ImGui::Checkbox("Show pages", &m_ShowPages);
+
+        ImGui::Text("Atlas: %u pages of %dx%d, %.1f%% used, built in %.1f ms", m_Atlas->GetPageCount(),
+            m_Atlas->GetPageSize(), m_Atlas->GetPageSize(), m_Atlas->GetOccupancy() * 100.0f, m_BuildTime);
+        ImGui::Text("Different sprites: %u", (unsigned int)m_Sprites.size());
+
+        const Renderer2D::Stats& stats = m_Renderer2D->GetStats();
+        ImGui::Text("Draw Calls: %u", stats.DrawCalls);
+        ImGui::Text("Quads: %u", stats.QuadCount);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
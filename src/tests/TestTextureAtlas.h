@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer2D.h"
+#include "TextureAtlas.h"
+#include "imgui/imgui.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Packs every image in res/textures into a TextureAtlas and draws a grid of sprites from it.
+	*	Each image can be cut into tiles, so there are far more different sprites than the batch shader has
+	*	texture slots, and they still go out in one draw call per batch.
+	*/
+	class TestTextureAtlas : public Test
+	{
+	public:
+		TestTextureAtlas();
+		~TestTextureAtlas();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		//	Cuts every image of the atlas into m_Tiles x m_Tiles sprites.
+		void BuildSprites();
+
+	private:
+
+		const char* m_Name;
+
+		std::unique_ptr<Renderer2D> m_Renderer2D;
+		std::unique_ptr<TextureAtlas> m_Atlas;
+		std::vector<std::string> m_Paths;
+		std::vector<SubTexture> m_Sprites;
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_QuadCount = 2000;
+		float m_QuadSize = 16.0f;
+		int m_Tiles = 4;
+		int m_BuiltTiles = 0;
+		//	Draws the pages themselves instead of the sprites.
+		bool m_ShowPages = false;
+		double m_BuildTime = 0.0;
+	};
+}
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#include "TestTextureCompression.h"
+
+#include "FrameUniforms.h"
+
+
+namespace test
+{
+
+    //  The choices of the format combo; only RGBA8 can be cooked without mipmaps here, to show what they're for.
+    static const char* FormatNames[] = { "RGBA8, no mipmaps", "RGBA8", "BC1", "BC3", "BC7" };
+    static const TextureFormat Formats[] = { TextureFormat::RGBA8, TextureFormat::RGBA8, TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+
+    TestTextureCompression::TestTextureCompression()
+        : m_Name{ "Texture Compression Test" }, m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)))
+    {
+        m_Renderer2D = std::make_unique<Renderer2D>();
+
+        m_Paths = {
+            "res/textures/T-REX.png",
+            "res/textures/common daisy flower.jpg",
+            "res/textures/morning glory.jpg",
+            "res/textures/osteospermom-voltage yellow_African daisy.jpg",
+            "res/textures/red_diamond_heart.png",
+            "res/textures/shark.jpg",
+            "res/textures/star_rasengan.png",
+            "res/textures/wallpaper_20436.jpg"
+        };
+
+        Cook();
+    }
+
+    TestTextureCompression::~TestTextureCompression()
+    {
+        std::cout << m_Name << " Closed!\n";
+    }
+
+    void TestTextureCompression::Cook()
+    {
+        m_BuiltImage = m_Image;
+        m_BuiltFormat = m_Format;
+        m_DecodeLoadTime = m_CookedLoadTime = 0.0;
+
+        TextureCooker::Options options;
+        options.Format = Formats[m_Format];
+        options.Mipmaps = m_Format != 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        CookedTexture cooked;
+        if (!TextureCooker::CookFile(m_Paths[m_Image], options, cooked))
+            std::cout << "Couldn't load " << m_Paths[m_Image] << '\n';
+        auto cookedAt = std::chrono::high_resolution_clock::now();
+        m_Texture = std::make_unique<Texture>(cooked, m_Paths[m_Image]);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        m_CookTime = std::chrono::duration<double, std::milli>(cookedAt - start).count();
+        m_UploadTime = std::chrono::duration<double, std::milli>(end - cookedAt).count();
+        m_UncompressedSize = (size_t)cooked.Width * cooked.Height * 4;
+    }
+
+    void TestTextureCompression::WriteAndCompareLoads()
+    {
+        const std::string& path = m_Paths[m_Image];
+        std::string cookedPath = TextureCooker::GetCookedPath(path);
+
+        TextureCooker::Options options;
+        options.Format = Formats[m_Format];
+        options.Mipmaps = m_Format != 0;
+        CookedTexture cooked;
+        if (!TextureCooker::CookFile(path, options, cooked) || !TextureCooker::Write(cookedPath, cooked))
+        {
+            std::cout << "Couldn't write " << cookedPath << '\n';
+            return;
+        }
+
+        //  Straight through Texture rather than the AssetManager, so neither load can come from its cache.
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            Texture decoded(path);
+        }
+        auto decodedAt = std::chrono::high_resolution_clock::now();
+        {
+            Texture loaded(cookedPath);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        m_DecodeLoadTime = std::chrono::duration<double, std::milli>(decodedAt - start).count();
+        m_CookedLoadTime = std::chrono::duration<double, std::milli>(end - decodedAt).count();
+        std::cout << "Wrote " << cookedPath << "; loading it took " << m_CookedLoadTime << " ms, decoding "
+            << path << " took " << m_DecodeLoadTime << " ms\n";
+    }
+
+    void TestTextureCompression::OnUpdate(float deltaTime)
+    {
+        if (m_BuiltImage != m_Image || m_BuiltFormat != m_Format)
+            Cook();
+    }
+
+    void TestTextureCompression::OnRender()
+    {
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer2D->ResetStats();
+        FrameUniforms::Get().SetCamera(m_View, m_Proj);
+        m_Renderer2D->BeginBatch();
+
+        //  The same texture at half the size each time, left to right; the small ones shimmer without mipmaps.
+        float aspect = m_Texture->GetHeight() > 0 ? (float)m_Texture->GetWidth() / m_Texture->GetHeight() : 1.0f;
+        float x = 0.0f;
+        for (float height = m_QuadSize; height >= 2.0f && x < 960.0f; height *= 0.5f)
+        {
+            glm::vec2 size(height * aspect, height);
+            m_Renderer2D->DrawQuad(glm::vec2(x, 0.0f), size, *m_Texture);
+            x += size.x + 8.0f;
+        }
+
+        m_Renderer2D->EndBatch();
+    }
+
+    void TestTextureCompression::OnImGuiRender()
+    {
+        std::vector<const char*> images;
+        for (const std::string& path : m_Paths)
+            images.push_back(path.c_str());
+        ImGui::Combo("Image", &m_Image, images.data(), (int)images.size());
+        ImGui::Combo("Format", &m_Format, FormatNames, (int)(sizeof(FormatNames) / sizeof(FormatNames[0])));
+        ImGui::SliderFloat("Quad Size", &m_QuadSize, 8.0f, 540.0f);
+
+        if (!TextureCooker::IsSupported(Formats[m_Format]))
+            ImGui::Text("This GPU can't sample %s; showing a placeholder", TextureCooker::GetFormatName(Formats[m_Format]));
+        ImGui::Text("%dx%d, cooked in %.1f ms, uploaded in %.2f ms", m_Texture->GetWidth(), m_Texture->GetHeight(), m_CookTime, m_UploadTime);
+        ImGui::Text("GPU memory: %.2f MB (RGBA8 without mipmaps: %.2f MB)",
+            m_Texture->GetSize() / (1024.0 * 1024.0), m_UncompressedSize / (1024.0 * 1024.0));
+
+        if (ImGui::Button("Write .ktx and compare loads"))
+            WriteAndCompareLoads();
+        if (m_CookedLoadTime > 0.0)
+            ImGui::Text("Loading the .ktx: %.2f ms, decoding the image: %.2f ms", m_CookedLoadTime, m_DecodeLoadTime);
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+#include "Renderer.h"
+#include "Renderer2D.h"
+#include "Texture.h"
+#include "TextureCooker.h"
+#include "imgui/imgui.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+
+namespace test
+{
+	/**
+	*	Cooks an image of res/textures with the TextureCooker in each of its formats and draws it at halving sizes,
+	*	so the memory, the quality and the aliasing of minified textures (with and without mipmaps) can be compared.
+	*	It can also write the cooked texture next to the image and time loading the .ktx against decoding the image.
+	*/
+	class TestTextureCompression : public Test
+	{
+	public:
+		TestTextureCompression();
+		~TestTextureCompression();
+
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		//	Cooks the selected image in the selected format and uploads it.
+		void Cook();
+		//	Writes the .ktx and times loading it against loading the original.
+		void WriteAndCompareLoads();
+
+	private:
+
+		const char* m_Name;
+
+		std::unique_ptr<Renderer2D> m_Renderer2D;
+		std::unique_ptr<Texture> m_Texture;
+		std::vector<std::string> m_Paths;
+
+		glm::mat4 m_Proj, m_View;
+
+		int m_Image = 0;
+		//	An index into the formats listed in OnImGuiRender().
+		int m_Format = 4;
+		int m_BuiltImage = -1, m_BuiltFormat = -1;
+		float m_QuadSize = 256.0f;
+
+		double m_CookTime = 0.0, m_UploadTime = 0.0;
+		size_t m_UncompressedSize = 0;
+		//	From WriteAndCompareLoads(); 0 until it's been run.
+		double m_DecodeLoadTime = 0.0, m_CookedLoadTime = 0.0;
+	};
+}